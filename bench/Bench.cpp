@@ -0,0 +1,253 @@
+// Description: Source file for the spider_bench harness: runs the registered cases and writes text or JSON.
+// Usage: spider_bench [--filter TEXT] [--repeats N] [--json PATH]
+#include "Bench.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+    std::atomic<uint64_t> g_allocations(0);
+    std::atomic<uint64_t> g_allocatedBytes(0);
+
+    void* countedAlloc(size_t size) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    std::vector<bench::Case>& cases() {
+        static std::vector<bench::Case> registry;
+        return registry;
+    }
+
+    struct Report {
+        std::string name;
+        std::function<void()> print;
+    };
+
+    std::vector<Report>& reports() {
+        static std::vector<Report> registry;
+        return registry;
+    }
+
+    struct Result {
+        std::string name;
+        size_t opsPerRun;
+        double medianNs;    // per op
+        double minNs;
+        double maxNs;
+        double allocationsPerOp;
+        double bytesPerOp;
+    };
+
+    Result measure(const bench::Case& benchCase, int repeats) {
+        // One untimed pass warms caches, lazily built tables and the branch predictors
+        if (benchCase.setup) benchCase.setup();
+        benchCase.run();
+
+        std::vector<double> samples;
+        samples.reserve(repeats);
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        for (int r = 0; r < repeats; ++r) {
+            if (benchCase.setup) benchCase.setup();
+            uint64_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+            uint64_t bytesBefore = g_allocatedBytes.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            benchCase.run();
+            auto stop = std::chrono::steady_clock::now();
+            allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+            bytes += g_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+            samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count() / benchCase.opsPerRun);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        Result result;
+        result.name = benchCase.name;
+        result.opsPerRun = benchCase.opsPerRun;
+        result.medianNs = samples[samples.size() / 2];
+        result.minNs = samples.front();
+        result.maxNs = samples.back();
+        const double totalOps = static_cast<double>(benchCase.opsPerRun) * repeats;
+        result.allocationsPerOp = allocations / totalOps;
+        result.bytesPerOp = bytes / totalOps;
+        return result;
+    }
+
+    // The whole argument must be a count >= 1
+    bool parseRepeats(const char* text, int& value) {
+        char* end = nullptr;
+        errno = 0;
+        long parsed = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE || parsed < 1 || parsed > INT_MAX) {
+            return false;
+        }
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    std::string jsonEscape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    bool writeJson(const char* path, const std::vector<Result>& results, int repeats) {
+        FILE* file = std::fopen(path, "w");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "{\n  \"repeats\": %d,\n  \"cases\": [", repeats);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::fprintf(file,
+                         "%s\n    {\"name\": \"%s\", \"ops_per_run\": %zu, \"ns_per_op\": %.3f, "
+                         "\"ns_per_op_min\": %.3f, \"ns_per_op_max\": %.3f, \"ops_per_sec\": %.1f, "
+                         "\"allocs_per_op\": %.4f, \"bytes_per_op\": %.1f}",
+                         i == 0 ? "" : ",", jsonEscape(r.name).c_str(), r.opsPerRun, r.medianNs,
+                         r.minNs, r.maxNs, 1e9 / r.medianNs, r.allocationsPerOp, r.bytesPerOp);
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+}
+
+// Every heap allocation in the process goes through these, so a case's count
+// includes what the code under test allocates internally
+void* operator new(size_t size) {
+    void* pointer = countedAlloc(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    void* pointer = countedAlloc(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+
+namespace bench {
+
+    void add(const Case& benchCase) {
+        cases().push_back(benchCase);
+    }
+
+    void add(const std::string& name, size_t opsPerRun, const std::function<void()>& run) {
+        Case benchCase;
+        benchCase.name = name;
+        benchCase.opsPerRun = opsPerRun;
+        benchCase.run = run;
+        add(benchCase);
+    }
+
+    void addReport(const std::string& name, const std::function<void()>& print) {
+        Report report;
+        report.name = name;
+        report.print = print;
+        reports().push_back(report);
+    }
+
+    uint64_t allocationCount() {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+
+    uint64_t allocatedBytes() {
+        return g_allocatedBytes.load(std::memory_order_relaxed);
+    }
+
+    volatile float g_floatSink;
+    const void* volatile g_pointerSink;
+
+    void consume(float value) {
+        g_floatSink = value;
+    }
+
+    void consume(const void* pointer) {
+        g_pointerSink = pointer;
+    }
+
+} // namespace bench
+
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    const char* filter = nullptr;
+    int repeats = 15;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc && parseRepeats(argv[i + 1], repeats)) {
+            ++i;
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter TEXT] [--repeats N] [--json PATH]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench::registerIKCases();
+    bench::registerKernelCases();
+
+    std::vector<Result> results;
+    std::printf("%-44s %12s %12s %14s %10s %12s\n", "case", "ns/op", "min ns/op", "ops/s", "allocs/op", "bytes/op");
+    for (const bench::Case& benchCase : cases()) {
+        if (filter && benchCase.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        Result r = measure(benchCase, repeats);
+        std::printf("%-44s %12.1f %12.1f %14.0f %10.2f %12.1f\n", r.name.c_str(), r.medianNs, r.minNs,
+                    1e9 / r.medianNs, r.allocationsPerOp, r.bytesPerOp);
+        results.push_back(r);
+    }
+
+    for (const Report& report : reports()) {
+        if (filter && report.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::printf("\n%s\n", report.name.c_str());
+        report.print();
+    }
+
+    if (jsonPath) {
+        if (!writeJson(jsonPath, results, repeats)) {
+            std::fprintf(stderr, "could not write %s\n", jsonPath);
+            return 1;
+        }
+        std::printf("\nwrote %s\n", jsonPath);
+    }
+    return 0;
+}
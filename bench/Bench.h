@@ -0,0 +1,48 @@
+// Description: Header file for the spider_bench harness: case registration, timing and allocation counting.
+#ifndef SPIDER_BENCH_H
+#define SPIDER_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    // One micro-benchmark. setup runs before every timed repetition and is not
+    // timed, so a case can rebuild whatever run consumes. run does opsPerRun
+    // operations; results are reported per operation.
+    struct Case {
+        std::string name;
+        size_t opsPerRun;
+        std::function<void()> setup;   // may be empty
+        std::function<void()> run;
+    };
+
+    // Adds a case to the registry; cases run in registration order
+    void add(const Case& benchCase);
+
+    // Shorthand for cases without a setup step
+    void add(const std::string& name, size_t opsPerRun, const std::function<void()>& run);
+
+    // Sections that print something other than a timing (e.g. solver accuracy).
+    // They run after the timed cases, only for the text report.
+    void addReport(const std::string& name, const std::function<void()>& print);
+
+    // Each translation unit with cases defines one of these and the harness calls
+    // them all from main, so nothing depends on static initialisation order
+    void registerIKCases();
+    void registerKernelCases();
+
+    // Heap allocations (operator new) made by this process so far, on any thread
+    uint64_t allocationCount();
+    uint64_t allocatedBytes();
+
+    // Keeps a result alive so the optimiser cannot drop the work that produced it
+    void consume(float value);
+    void consume(const void* pointer);
+
+} // namespace bench
+
+#endif // SPIDER_BENCH_H
@@ -0,0 +1,223 @@
+// Description: Micro-benchmark cases for the leg IK solvers on the 7-segment spider legs.
+#include "Bench.h"
+#include "global/GlobalConfig.h"
+#include "spider/Leg.h"
+#include "spider/LegIKBatch.h"
+#include "spider/LegIKSolver.h"
+#include "spider/LegKinematics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+    const float* const THETA_MIN = LEG_JOINT_MIN_ANGLES;
+    const float* const THETA_MAX = LEG_JOINT_MAX_ANGLES;
+    const int MAX_ITER = LEG_IK_MAX_ITERATIONS;
+    const float TOL = LEG_IK_TOLERANCE;
+    const float TARGET_X = LEG_IK_TARGET_REACH;
+    const int N = LEG_SEGMENT_COUNT;
+    const size_t SOLVES = 4096;
+
+    // The solver as it was before incremental FK: a full forward pass for every joint step
+    void solveCCDFullForward(float xTarget, float yTarget, float L, int n, float* theta) {
+        float x[spider::LEG_KINEMATICS_MAX_SEGMENTS + 1], y[spider::LEG_KINEMATICS_MAX_SEGMENTS + 1];
+        for (int iter = 0; iter < MAX_ITER; ++iter) {
+            spider::forwardKinematics(theta, n, L, x, y);
+            float dx = x[n] - xTarget, dy = y[n] - yTarget;
+            if (std::sqrt(dx * dx + dy * dy) < TOL) break;
+            for (int i = n - 1; i >= 0; --i) {
+                spider::forwardKinematics(theta, n, L, x, y);
+                float a1 = std::atan2(yTarget - y[i], xTarget - x[i]) * 180.0f / static_cast<float>(M_PI);
+                float a2 = std::atan2(y[n] - y[i], x[n] - x[i]) * 180.0f / static_cast<float>(M_PI);
+                theta[i] = std::min(std::max(theta[i] + (a1 - a2), THETA_MIN[i]), THETA_MAX[i]);
+            }
+        }
+    }
+
+    // Body heights across the whole BODY_MIN_Y..BODY_MAX_Y range, as the IK sees them
+    std::vector<float> makeTargets(size_t count) {
+        std::vector<float> targets(count);
+        for (size_t i = 0; i < count; ++i) {
+            float t = static_cast<float>(i) / static_cast<float>(count - 1);
+            targets[i] = -(BODY_MIN_Y + t * (BODY_MAX_Y - BODY_MIN_Y));
+        }
+        return targets;
+    }
+
+    // Shared by every case; built once when the cases are registered
+    struct IKData {
+        std::vector<float> targetX;
+        std::vector<float> targetY;
+        std::vector<float> angles;
+        std::vector<float> thetaMin;
+        std::vector<float> thetaMax;
+        spider::LegIKBatch batch;
+    };
+
+    IKData& data() {
+        static IKData d;
+        return d;
+    }
+
+    void resetAngles() {
+        std::fill(data().angles.begin(), data().angles.end(), 0.0f);
+    }
+
+    // Convergence of each backend from the zero pose on the real joint limits
+    void printSolverTable() {
+        IKData& d = data();
+        std::printf("  %-10s %12s %12s %12s %10s\n", "solver", "mean iters", "mean resid", "max resid", "within tol");
+        const spider::LegIKMethod methods[spider::LEG_IK_METHOD_COUNT] = {
+            spider::LegIKMethod::CCD, spider::LegIKMethod::FABRIK, spider::LegIKMethod::TwoBone
+        };
+        for (spider::LegIKMethod method : methods) {
+            const spider::LegIKSolver& solver = spider::getLegIKSolver(method);
+            spider::LegIKProblem problem;
+            problem.targetX = TARGET_X;
+            problem.segmentLength = LEG_SEGMENT_LENGTH;
+            problem.segmentCount = N;
+            problem.maxIter = MAX_ITER;
+            problem.tolerance = TOL;
+            problem.thetaMin = THETA_MIN;
+            problem.thetaMax = THETA_MAX;
+            problem.restPose = LEG_IK_FOLDED_POSE;
+
+            resetAngles();
+            long iterations = 0;
+            double residualSum = 0.0;
+            float residualMax = 0.0f;
+            size_t withinTolerance = 0;
+            for (size_t i = 0; i < SOLVES; ++i) {
+                problem.targetY = d.targetY[i];
+                spider::LegIKResult result = solver.solve(problem, &d.angles[i * N]);
+                iterations += result.iterations;
+                residualSum += result.residual;
+                residualMax = std::max(residualMax, result.residual);
+                withinTolerance += result.residual < TOL ? 1 : 0;
+            }
+            std::printf("  %-10s %12.2f %12.4f %12.4f %9.1f%%\n", solver.getName(),
+                        static_cast<double>(iterations) / SOLVES, residualSum / SOLVES, residualMax,
+                        100.0 * withinTolerance / SOLVES);
+        }
+    }
+}
+
+namespace bench {
+
+    void registerIKCases() {
+        IKData& d = data();
+        d.targetY = makeTargets(SOLVES);
+        d.targetX.assign(SOLVES, TARGET_X);
+        d.angles.assign(SOLVES * N, 0.0f);
+        d.thetaMin.assign(THETA_MIN, THETA_MIN + N);
+        d.thetaMax.assign(THETA_MAX, THETA_MAX + N);
+
+        d.batch.legCount = SOLVES;
+        d.batch.segmentCount = N;
+        d.batch.segmentLength = LEG_SEGMENT_LENGTH;
+        d.batch.maxIter = MAX_ITER;
+        d.batch.tolerance = TOL;
+        d.batch.targetX = d.targetX.data();
+        d.batch.targetY = d.targetY.data();
+        d.batch.thetaMin = THETA_MIN;
+        d.batch.thetaMax = THETA_MAX;
+        d.batch.limitStride = 0;
+        d.batch.thetaOut = d.angles.data();
+
+        Case ccdFull;
+        ccdFull.name = "ik/ccd full forward pass";
+        ccdFull.opsPerRun = SOLVES;
+        ccdFull.setup = resetAngles;
+        ccdFull.run = [] {
+            IKData& d = data();
+            for (size_t i = 0; i < SOLVES; ++i) {
+                solveCCDFullForward(TARGET_X, d.targetY[i], LEG_SEGMENT_LENGTH, N, &d.angles[i * N]);
+            }
+            consume(d.angles[N - 1]);
+        };
+        add(ccdFull);
+
+        Case ccd;
+        ccd.name = "ik/ccd incremental";
+        ccd.opsPerRun = SOLVES;
+        ccd.setup = resetAngles;
+        ccd.run = [] {
+            IKData& d = data();
+            for (size_t i = 0; i < SOLVES; ++i) {
+                spider::solveCCD(TARGET_X, d.targetY[i], LEG_SEGMENT_LENGTH, N, MAX_ITER, TOL,
+                                 THETA_MIN, THETA_MAX, &d.angles[i * N]);
+            }
+            consume(d.angles[N - 1]);
+        };
+        add(ccd);
+
+        Case batched;
+        batched.name = std::string("ik/ccd batched (") + spider::legIKBatchInstructionSet() + ")";
+        batched.opsPerRun = SOLVES;
+        batched.setup = resetAngles;
+        batched.run = [] {
+            spider::solveLegIKBatch(data().batch);
+            consume(data().angles[N - 1]);
+        };
+        add(batched);
+
+        // The vector API the simulation used before the batched systems; allocates its result
+        add("ik/Leg::inverseKinematicsCCD", SOLVES, [] {
+            IKData& d = data();
+            float sum = 0.0f;
+            for (size_t i = 0; i < SOLVES; ++i) {
+                std::vector<float> theta = spider::Leg::inverseKinematicsCCD(
+                    TARGET_X, d.targetY[i], LEG_SEGMENT_LENGTH, N, MAX_ITER, TOL, d.thetaMin, d.thetaMax);
+                sum += theta[N - 1];
+            }
+            consume(sum);
+        });
+
+        // Forward passes over the poses the batched solver left behind
+        add("ik/Leg::forwardKinematics", SOLVES, [] {
+            IKData& d = data();
+            std::vector<float> theta(N), x, y;
+            float sum = 0.0f;
+            for (size_t i = 0; i < SOLVES; ++i) {
+                std::copy(&d.angles[i * N], &d.angles[i * N] + N, theta.begin());
+                spider::Leg::forwardKinematics(theta, LEG_SEGMENT_LENGTH, x, y);
+                sum += x[N] + y[N];
+            }
+            consume(sum);
+        });
+
+        const spider::LegIKMethod methods[spider::LEG_IK_METHOD_COUNT] = {
+            spider::LegIKMethod::CCD, spider::LegIKMethod::FABRIK, spider::LegIKMethod::TwoBone
+        };
+        for (spider::LegIKMethod method : methods) {
+            const spider::LegIKSolver* solver = &spider::getLegIKSolver(method);
+            Case solverCase;
+            solverCase.name = std::string("ik/solver ") + solver->getName() + " (from zero pose)";
+            solverCase.opsPerRun = SOLVES;
+            solverCase.setup = resetAngles;
+            solverCase.run = [solver] {
+                IKData& d = data();
+                spider::LegIKProblem problem;
+                problem.targetX = TARGET_X;
+                problem.segmentLength = LEG_SEGMENT_LENGTH;
+                problem.segmentCount = N;
+                problem.maxIter = MAX_ITER;
+                problem.tolerance = TOL;
+                problem.thetaMin = THETA_MIN;
+                problem.thetaMax = THETA_MAX;
+                problem.restPose = LEG_IK_FOLDED_POSE;
+                for (size_t i = 0; i < SOLVES; ++i) {
+                    problem.targetY = d.targetY[i];
+                    solver->solve(problem, &d.angles[i * N]);
+                }
+                consume(d.angles[N - 1]);
+            };
+            add(solverCase);
+        }
+
+        addReport("ik solver accuracy (from zero pose)", printSolverTable);
+    }
+
+} // namespace bench
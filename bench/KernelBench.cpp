@@ -0,0 +1,203 @@
+// Description: Micro-benchmark cases for noise, body mesh generation, the rig, transforms and collisions.
+#include "Bench.h"
+#include "global/GlobalConfig.h"
+#include "sim/World.h"
+#include "spider/Abdomen.h"
+#include "spider/Cephalothorax.h"
+#include "spider/SpiderRenderer.h"
+#include "spider/SpiderState.h"
+#include "utils/PerlinNoise.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const size_t NOISE_SAMPLES = 1 << 16;
+    const size_t MESHES_PER_RUN = 16;
+    const size_t RIGS_PER_RUN = 64;
+    const size_t TRANSFORM_STATES = 1024;
+    const size_t COLLISION_STEPS = 1024;
+    const int COLLISION_AI_SPIDERS = 500;
+    const int COLLISION_OBSTACLES = 100;
+    const unsigned COLLISION_SEED = 1234;
+
+    // Swallows World's collision log so printing is not part of the timing
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    // Pseudo-random but fixed spider poses, so every run sees the same matrices
+    std::vector<spider::SpiderState> makeStates(size_t count) {
+        std::vector<spider::SpiderState> states(count);
+        for (size_t i = 0; i < count; ++i) {
+            spider::SpiderState& s = states[i];
+            float t = static_cast<float>(i);
+            s.position = vec3(std::sin(t * 0.37f) * 20.0f, 0.7f, std::cos(t * 0.61f) * 20.0f);
+            s.forward = vec3(0.0f, 0.0f, 1.0f);
+            s.yaw = std::fmod(t * 37.0f, 360.0f);
+            s.scale = 0.25f + 0.75f * static_cast<float>(i % 4) / 3.0f;
+            s.walkingForward = true;
+            s.walkingBackward = s.turningLeft = s.turningRight = false;
+            s.legAnimationCycle = std::fmod(t * 0.013f, 1.0f);
+            s.abdomenShakeCycle = std::fmod(t * 0.029f, 1.0f);
+            s.jumpTriggered = s.jumping = false;
+            s.jumpTime = 0.0f;
+            for (int leg = 0; leg < LEG_COUNT; ++leg) {
+                for (int joint = 0; joint < LEG_SEGMENT_COUNT; ++joint) {
+                    s.jointAngles[leg][joint] = LEG_IK_FOLDED_POSE[joint];
+                }
+            }
+        }
+        return states;
+    }
+
+    std::unique_ptr<World> g_collisionWorld;
+
+    // The noise case's lattice in structure-of-arrays form, with room for every result
+    struct NoiseData {
+        std::vector<float> x, y, z;
+        std::vector<float> value, gradX, gradY, gradZ;
+    };
+
+    NoiseData& noiseData() {
+        static NoiseData d;
+        if (d.x.empty()) {
+            for (size_t i = 0; i < NOISE_SAMPLES; ++i) {
+                d.x.push_back(static_cast<float>(i & 63) * 0.173f);
+                d.y.push_back(static_cast<float>((i >> 6) & 31) * 0.219f);
+                d.z.push_back(static_cast<float>(i >> 11) * 0.307f);
+            }
+            d.value.resize(NOISE_SAMPLES);
+            d.gradX.resize(NOISE_SAMPLES);
+            d.gradY.resize(NOISE_SAMPLES);
+            d.gradZ.resize(NOISE_SAMPLES);
+        }
+        return d;
+    }
+
+    void addBatchedNoiseCase(NoiseKind kind, const char* kindName, bool gradients) {
+        std::string name = std::string("noise/") + kindName + " batched" + (gradients ? " + gradient" : "") +
+                           " (" + PerlinNoise::batchInstructionSet() + ")";
+        noiseData(); // built here so no timed run pays for it
+        bench::add(name, NOISE_SAMPLES, [kind, gradients] {
+            static PerlinNoise perlin;
+            NoiseData& d = noiseData();
+            NoiseBatch batch;
+            batch.count = NOISE_SAMPLES;
+            batch.x = d.x.data();
+            batch.y = d.y.data();
+            batch.z = d.z.data();
+            batch.value = d.value.data();
+            if (gradients) {
+                batch.gradX = d.gradX.data();
+                batch.gradY = d.gradY.data();
+                batch.gradZ = d.gradZ.data();
+            }
+            perlin.evaluate(kind, batch);
+            bench::consume(d.value[NOISE_SAMPLES - 1] + d.gradX[NOISE_SAMPLES - 1]);
+        });
+    }
+}
+
+namespace bench {
+
+    void registerKernelCases() {
+        add("noise/PerlinNoise::noise", NOISE_SAMPLES, [] {
+            static PerlinNoise perlin;
+            float sum = 0.0f;
+            // A lattice the size of a body mesh's noise domain, off the integer grid
+            for (size_t i = 0; i < NOISE_SAMPLES; ++i) {
+                float x = static_cast<float>(i & 63) * 0.173f;
+                float y = static_cast<float>((i >> 6) & 31) * 0.219f;
+                float z = static_cast<float>(i >> 11) * 0.307f;
+                sum += perlin.noise(x, y, z);
+            }
+            consume(sum);
+        });
+
+        addBatchedNoiseCase(NoiseKind::Perlin, "perlin", false);
+        addBatchedNoiseCase(NoiseKind::Perlin, "perlin", true);
+        addBatchedNoiseCase(NoiseKind::Simplex, "simplex", true);
+
+        // One finest-level mesh per op, radii as the meshes are built at startup
+        const int stacks = MESH_LOD_TESSELLATION[0];
+        add("mesh/Cephalothorax::generateVertexData", MESHES_PER_RUN, [stacks] {
+            const float baseRadius = ABDOMEN_RADIUS * 0.8f;
+            std::vector<GLfloat> vertices;
+            for (size_t i = 0; i < MESHES_PER_RUN; ++i) {
+                vertices.clear();
+                spider::Cephalothorax::generateVertexData(stacks, stacks,
+                                                          baseRadius * ABDOMEN_SCALE_X * 0.7f,
+                                                          baseRadius * ABDOMEN_SCALE_X * 0.7f,
+                                                          baseRadius * ABDOMEN_SCALE_Z * 1.1f, vertices);
+            }
+            consume(vertices.data());
+        });
+
+        add("mesh/Abdomen::generateVertices", MESHES_PER_RUN, [stacks] {
+            std::vector<GLfloat> vertices;
+            for (size_t i = 0; i < MESHES_PER_RUN; ++i) {
+                vertices.clear();
+                spider::Abdomen::generateVertices(stacks, stacks, ABDOMEN_RADIUS * ABDOMEN_SCALE_X,
+                                                  ABDOMEN_RADIUS, ABDOMEN_RADIUS * ABDOMEN_SCALE_Z, vertices);
+            }
+            consume(vertices.data());
+        });
+
+        // Rest surface, leg attachment selection and anchors: what getLegAttachmentPoints returns
+        add("rig/Cephalothorax::buildRig", RIGS_PER_RUN, [] {
+            float sum = 0.0f;
+            for (size_t i = 0; i < RIGS_PER_RUN; ++i) {
+                spider::SpiderRig rig = spider::Cephalothorax::buildRig();
+                sum += rig.legAttachments[LEG_COUNT - 1].z;
+            }
+            consume(sum);
+        });
+
+        // The Angel mat4 chain every drawn spider goes through each frame
+        add("transform/SpiderRenderer::computePartTransforms", TRANSFORM_STATES, [] {
+            static const std::vector<spider::SpiderState> states = makeStates(TRANSFORM_STATES);
+            spider::SpiderRenderer::PartTransforms parts;
+            float sum = 0.0f;
+            for (const spider::SpiderState& state : states) {
+                spider::SpiderRenderer::computePartTransforms(state, parts);
+                sum += parts.legRoots[LEG_COUNT - 1][0][3];
+            }
+            consume(sum);
+        });
+
+        // The player walks a fixed path through the world, eating as it goes
+        Case collisions;
+        collisions.name = "collision/World::checkCollisions";
+        collisions.opsPerRun = COLLISION_STEPS;
+        // Same layout every repetition; the obstacle models load once and stay resident
+        collisions.setup = [] {
+            std::srand(COLLISION_SEED);
+            g_collisionWorld.reset(new World());
+            g_collisionWorld->setupObstacles(0, COLLISION_OBSTACLES); // no shader program: nothing is drawn
+            std::srand(COLLISION_SEED);
+            g_collisionWorld->initAISpiders(COLLISION_AI_SPIDERS);
+        };
+        collisions.run = [] {
+            NullBuffer discard;
+            std::streambuf* previous = std::cout.rdbuf(&discard);
+            int events = 0;
+            for (size_t i = 0; i < COLLISION_STEPS; ++i) {
+                float t = static_cast<float>(i) / COLLISION_STEPS;
+                g_collisionWorld->player.setPosition(vec3(-20.0f + 40.0f * t, 0.7f, 15.0f * std::sin(t * 25.0f)));
+                CollisionEvents hit = g_collisionWorld->checkCollisions();
+                events += hit.obstaclesHit + hit.spidersEaten;
+            }
+            std::cout.rdbuf(previous);
+            consume(static_cast<float>(events));
+        };
+        add(collisions);
+    }
+
+} // namespace bench
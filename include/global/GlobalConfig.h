@@ -17,3 +17,60 @@ const float NOISE_STRENGHT = 0.3f;
 // Head configuration
 const float HEAD_SCALE = 0.4f;
 const float HEAD_SCALE_Z = 0.85f;
+
+// Locomotion
+const float SPIDER_WALK_SPEED = 1.5f;      // units per second
+const float SPIDER_TURN_SPEED = 90.0f;     // degrees per second
+const float LEG_ANIMATION_SPEED = 1.4f;    // gait cycles per second
+const float ABDOMEN_SHAKE_SPEED = 3.0f;
+
+// Fixed-rate simulation clock. A frame runs at most SIM_MAX_TICKS_PER_FRAME ticks;
+// wall time beyond that is dropped, so one long hitch cannot snowball.
+const float SIM_DEFAULT_TICK_RATE = 60.0f;  // ticks per simulated second
+const int SIM_MAX_TICKS_PER_FRAME = 5;
+// Rendered spiders blend their last two ticks, unless one moved further than this
+// in a single tick: then it was swapped or respawned and is drawn where it is now
+const float INTERPOLATION_SNAP_DISTANCE = 1.0f;
+
+// Leg configuration
+const int LEG_COUNT = 8;
+const int LEG_SEGMENT_COUNT = 7;
+const float LEG_SEGMENT_LENGTH = 0.6f;
+const float LEG_MAX_SWING_ANGLE = 15.0f;
+const float LEG_REST_JOINT_ANGLES[LEG_SEGMENT_COUNT] = {20.0f, 5.0f, -10.0f, -35.0f, -20.0f, -30.0f, -10.0f};
+
+// Leg IK, shared by the player and the AI population
+const int LEG_IK_MAX_ITERATIONS = 10;
+const float LEG_IK_TOLERANCE = 0.01f;
+const float LEG_IK_TARGET_REACH = 3.0f; // horizontal distance from attachment to foot target
+const float LEG_JOINT_MIN_ANGLES[LEG_SEGMENT_COUNT] = {30.0f, -15.0f, -40.0f, -30.0f, -30.0f, -30.0f, -30.0f};
+const float LEG_JOINT_MAX_ANGLES[LEG_SEGMENT_COUNT] = {90.0f, 15.0f, 40.0f, 40.0f, 0.0f, 0.0f, 0.0f};
+// Shared IK solution cache: targets are snapped to this grid (world units), so the
+// quantization error of a cached pose is at most half of it per axis
+const bool LEG_IK_CACHE_ENABLED = true;
+const float LEG_IK_CACHE_QUANTUM = 0.001f;
+// Shape the two-bone solver holds its fixed joints at: curled down towards the ground
+const float LEG_IK_FOLDED_POSE[LEG_SEGMENT_COUNT] = {30.0f, -15.0f, -40.0f, 0.0f, -30.0f, -30.0f, -30.0f};
+
+// Abdomen animation
+const float ABDOMEN_MAX_SHAKE_AMPLITUDE = 5.0f;
+
+// Level of detail, finest first. Body, abdomen and head spheres use MESH_LOD_TESSELLATION
+// stacks and slices, the eyes EYE_LOD_TESSELLATION. Every part builds all levels up
+// front and hands them out through getMesh(lod); level 0 is the full tessellation and
+// the only one a part's own draw() uses, coarser levels are picked per spider by
+// SpiderRenderer.
+const int MESH_LOD_COUNT = 4;
+const int MESH_LOD_TESSELLATION[MESH_LOD_COUNT] = {30, 16, 8, 4};
+const int EYE_LOD_TESSELLATION[MESH_LOD_COUNT] = {10, 8, 6, 4};
+// A spider switches to level i + 1 once its projected bounding radius drops below
+// LOD_SCREEN_RADIUS[i] pixels, and back once it grows past it again. The size has to
+// cross the threshold by LOD_HYSTERESIS (a fraction) first, so it does not flicker.
+const float LOD_SCREEN_RADIUS[MESH_LOD_COUNT - 1] = {160.0f, 60.0f, 24.0f};
+const float LOD_HYSTERESIS = 0.15f;
+// Far legs merge this many consecutive segments into one straight segment
+const int LEG_LOD_JOINT_STRIDE[MESH_LOD_COUNT] = {1, 1, 2, 4};
+
+// Body height limits for moveBodyUp / moveBodyDown
+const float BODY_MIN_Y = 0.30f;
+const float BODY_MAX_Y = 2.0f;
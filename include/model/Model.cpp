@@ -1,18 +1,22 @@
 #include <GL/glew.h>
 #include "Model.h"
+#include "utils/DrawStats.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <map>
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "../external/Angel/inlcude/Angel/Angel.h"
 using namespace Angel;
 
 Model::Model(const std::string& path)
-    : program(0), vertexCount(0)
+    : program(0), vertexCount(0), boundingCenter(0.0f, 0.0f, 0.0f), boundingRadius(0.0f)
 {
     std::cerr << "Model(path) constructor is not yet implemented.\n";
 }
 
 Model::Model(const std::string& objPath, const std::string& mtlPath, GLuint shaderProgram)
-    : program(shaderProgram)
+    : program(shaderProgram), vertexCount(0), boundingCenter(0.0f, 0.0f, 0.0f), boundingRadius(0.0f)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -47,19 +51,20 @@ Model::Model(const std::string& objPath, const std::string& mtlPath, GLuint shad
     }
 
     vertexCount = vertices.size();
+    computeBounds(vertices);
 
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &nbo);
+    vao = GLVertexArray::create();
+    vbo = GLBuffer::create();
+    nbo = GLBuffer::create();
 
-    glBindVertexArray(vao);
+    glBindVertexArray(vao.get());
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo.get());
     glBufferData(GL_ARRAY_BUFFER, sizeof(vec4) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, nbo);
+    glBindBuffer(GL_ARRAY_BUFFER, nbo.get());
     glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * normals.size(), normals.data(), GL_STATIC_DRAW);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(1);
@@ -67,12 +72,67 @@ Model::Model(const std::string& objPath, const std::string& mtlPath, GLuint shad
     glBindVertexArray(0);
 }
 
-void Model::draw(const mat4& modelView, const mat4& projection) {
+void Model::draw(const mat4& modelMatrix) {
     glUseProgram(program);
-    glUniformMatrix4fv(glGetUniformLocation(program, "model_view"), 1, GL_TRUE, modelView);
-    glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_TRUE, projection);
+    glUniformMatrix4fv(glGetUniformLocation(program, "model"), 1, GL_TRUE, modelMatrix);
 
-    glBindVertexArray(vao);
+    glBindVertexArray(vao.get());
     glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    recordDrawCall(1, vertexCount / 3);
     glBindVertexArray(0);
-}
\ No newline at end of file
+}
+
+namespace {
+    std::map<std::string, std::shared_ptr<Model> >& residentModels() {
+        static std::map<std::string, std::shared_ptr<Model> > models;
+        return models;
+    }
+}
+
+std::shared_ptr<Model> Model::acquire(const std::string& path) {
+    std::shared_ptr<Model>& model = residentModels()[path];
+    if (!model) {
+        model = std::make_shared<Model>(path);
+    }
+    return model;
+}
+
+void Model::releaseAll() {
+    residentModels().clear();
+}
+
+void Model::computeBounds(const std::vector<vec4>& positions) {
+    if (positions.empty()) {
+        return;
+    }
+    // Centre of the bounding box; the sphere then only has to reach the farthest vertex
+    vec3 lo(positions[0].x, positions[0].y, positions[0].z);
+    vec3 hi = lo;
+    for (const vec4& p : positions) {
+        lo = vec3(std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z));
+        hi = vec3(std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z));
+    }
+    boundingCenter = (lo + hi) * 0.5f;
+    float radiusSq = 0.0f;
+    for (const vec4& p : positions) {
+        vec3 d = vec3(p.x, p.y, p.z) - boundingCenter;
+        radiusSq = std::max(radiusSq, dot(d, d));
+    }
+    boundingRadius = std::sqrt(radiusSq);
+}
+
+const vec3& Model::getBoundingCenter() const {
+    return boundingCenter;
+}
+
+float Model::getBoundingRadius() const {
+    return boundingRadius;
+}
+
+GLuint Model::getVertexArray() const {
+    return vao.get();
+}
+
+GLsizei Model::getVertexCount() const {
+    return static_cast<GLsizei>(vertexCount);
+}
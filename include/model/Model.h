@@ -2,6 +2,7 @@
 #define MODEL_H
 
 #include <GL/glew.h> 
+#include <memory>
 #include <string>
 #include <vector>
 #include <GL/glew.h>
@@ -11,6 +12,7 @@
 #endif
 #include "../../external/tinyobjloader/tiny_obj_loader.h"
 #include "../external/Angel/inlcude/Angel/Angel.h"
+#include "utils/GLHandle.h"
 
 using namespace Angel;
 
@@ -18,16 +20,41 @@ class Model {
 public:
     Model(const std::string& path);
     Model(const std::string& objPath, const std::string& mtlPath, GLuint shaderProgram);
-    void draw(const mat4& modelView, const mat4& projection);
+
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    Model(Model&&) = default;
+    Model& operator=(Model&&) = default;
+
+    // Loads each path once and shares it, so obstacles using the same model also
+    // share its vertex array. Loaded models stay resident until releaseAll, so
+    // dropping an obstacle never deletes GL objects, whatever thread drops it.
+    static std::shared_ptr<Model> acquire(const std::string& path);
+    // Drops the resident references; call with the GL context current, once
+    // nothing will draw a model again
+    static void releaseAll();
+
+    void draw(const mat4& modelMatrix);
+
+    GLuint getVertexArray() const;
+    GLsizei getVertexCount() const;
+
+    // Model-space bounding sphere of the loaded vertices (zero radius if nothing loaded)
+    const vec3& getBoundingCenter() const;
+    float getBoundingRadius() const;
 
 private:
     std::vector<vec3> vertices;
     std::vector<vec3> normals;
-    GLuint vao, vbo, nbo;
+    GLVertexArray vao;
+    GLBuffer vbo, nbo;
     GLuint shaderProgram;
     GLuint program;
     int vertexCount;
+    vec3 boundingCenter;
+    float boundingRadius;
     void loadModel(const std::string& path);
+    void computeBounds(const std::vector<vec4>& positions);
 };
 
 #endif // MODEL_H
\ No newline at end of file
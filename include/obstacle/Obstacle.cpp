@@ -3,28 +3,40 @@
 #include <vector>
 
 Obstacle::Obstacle(vec3 position, float size, int pointValue, GLuint shaderProgram, const std::string& modelPath)
-    : position(position), size(size), pointValue(pointValue), shader(shaderProgram), model(modelPath) {}
-
-void Obstacle::draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& viewMatrix, const mat4& projMatrix) {
-    mat4 modelMat = Translate(position) * Scale(size);
-    mat4 modelView = viewMatrix * modelMat;
-
-    glUseProgram(shader);
-
-    GLint colorLoc = glGetUniformLocation(shader, "uColor");
+    : position(position), size(size), pointValue(pointValue), shader(shaderProgram), model(Model::acquire(modelPath)) {}
+
+void ObstacleDraw::enqueue(RenderQueue& queue, GLint modelLoc, GLint colorLoc) const {
+    DrawPacket packet;
+    packet.program = shader;
+    packet.vertexArray = model->getVertexArray();
+    packet.count = model->getVertexCount();
+    packet.indexed = false;
+    packet.modelLoc = modelLoc;
+    packet.model = Translate(position) * Scale(size);
+    packet.colorLoc = colorLoc;
     if (pointValue < 0)
-        glUniform4f(colorLoc, 0.0f, 0.0f, 0.0f, 1.0f); // ceza
+        packet.color = vec4(0.0f, 0.0f, 0.0f, 1.0f); // ceza
     else
-        glUniform4f(colorLoc, 1.0f, 1.0f, 1.0f, 1.0f); // ödül
+        packet.color = vec4(1.0f, 1.0f, 1.0f, 1.0f); // ödül
+    queue.push(packet);
+}
 
-    glUniformMatrix4fv(modelViewLoc, 1, GL_TRUE, modelView);
-    glUniformMatrix4fv(projectionLoc, 1, GL_TRUE, projMatrix);
+bool ObstacleDraw::isVisible(const ViewFrustum& frustum) const {
+    return frustum.intersectsSphere(position + model->getBoundingCenter() * size, model->getBoundingRadius() * size);
+}
 
-    model.draw(viewMatrix, projMatrix);
+ObstacleDraw Obstacle::getDrawRecord() const {
+    ObstacleDraw record;
+    record.position = position;
+    record.size = size;
+    record.pointValue = pointValue;
+    record.shader = shader;
+    record.model = model.get();
+    return record;
 }
 
 void Obstacle::setModel(const std::string& modelPath) {
-    model = Model(modelPath);
+    model = Model::acquire(modelPath);
 }
 
 const vec3& Obstacle::getPosition() const {
@@ -33,4 +45,4 @@ const vec3& Obstacle::getPosition() const {
 
 int Obstacle::getPointValue() const {
     return pointValue;
-}
\ No newline at end of file
+}
@@ -4,11 +4,37 @@
 #include <GL/glew.h>
 #include "../external/Angel/inlcude/Angel/Angel.h"
 #include "model/Model.h"
+#include "utils/RenderQueue.h"
+#include "utils/ViewFrustum.h"
+#include <memory>
+
+// What the render thread needs to draw one obstacle, copied into each frame
+// snapshot. The model is not owned: Model::acquire keeps it resident until
+// Model::releaseAll, so the pointer outlives any obstacle that used it.
+struct ObstacleDraw {
+    vec3 position;
+    float size;
+    int pointValue;
+    GLuint shader;
+    const Model* model;
+
+    // Emits one packet; obstacles sharing a model share its VAO and sort together
+    void enqueue(RenderQueue& queue, GLint modelLoc, GLint colorLoc) const;
+    // Tests the model's bounding sphere, placed and scaled like the drawn model
+    bool isVisible(const ViewFrustum& frustum) const;
+};
 
 class Obstacle {
 public:
     Obstacle(vec3 position, float size, int pointValue, GLuint shaderProgram, const std::string& modelPath);
-    void draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& viewMatrix, const mat4& projMatrix);
+
+    // Obstacles are moved around the vector, never copied
+    Obstacle(const Obstacle&) = delete;
+    Obstacle& operator=(const Obstacle&) = delete;
+    Obstacle(Obstacle&&) = default;
+    Obstacle& operator=(Obstacle&&) = default;
+
+    ObstacleDraw getDrawRecord() const;
     const vec3& getPosition() const;
     int getPointValue() const;
     void setModel(const std::string& modelPath);
@@ -17,9 +43,8 @@ private:
     vec3 position;
     float size;
     int pointValue;
-    GLuint vao, vbo;
     GLuint shader;
-    Model model;
+    std::shared_ptr<Model> model;
 };
 
 #endif // OBSTACLE_H
\ No newline at end of file
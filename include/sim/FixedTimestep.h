@@ -0,0 +1,46 @@
+// Description: Header file for FixedTimestep, the fixed-rate simulation clock.
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <cstdint>
+
+// Turns variable frame times into a whole number of fixed ticks:
+//
+//   clock.beginFrame(frameSeconds);
+//   while (clock.tick()) {
+//       simulate(clock.getTickTime(), clock.getTickSeconds());
+//   }
+//   render(clock.getAlpha());
+//
+// Leftover time carries into the next frame, so the simulation advances at the
+// tick rate however fast frames come. getAlpha() is how far the frame has got
+// into the next, not yet simulated, tick.
+class FixedTimestep {
+public:
+    FixedTimestep(float tickRate, int maxTicksPerFrame);
+
+    // Adds a frame's wall time. More than maxTicksPerFrame ticks' worth is dropped
+    // (the spiral-of-death clamp): the simulation slows down instead of falling behind.
+    void beginFrame(double frameSeconds);
+
+    // Consumes one tick of accumulated time; false once less than a tick is left
+    bool tick();
+
+    float getTickSeconds() const;
+    // Simulated time at the start of the tick tick() just handed out
+    float getTickTime() const;
+    // Accumulated fraction of a tick, 0..1
+    float getAlpha() const;
+
+    uint64_t getTickCount() const;
+    double getDroppedSeconds() const;
+
+private:
+    double tickSeconds_;
+    int maxTicksPerFrame_;
+    double accumulator_;
+    uint64_t ticks_;
+    double droppedSeconds_;
+};
+
+#endif // FIXED_TIMESTEP_H
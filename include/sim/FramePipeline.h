@@ -0,0 +1,45 @@
+// Description: Header file for FramePipeline, the per-frame simulation task graph.
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <vector>
+#include "sim/World.h"
+#include "spider/SpiderState.h"
+#include "utils/JobSystem.h"
+
+// One frame of simulation as a task graph on the job system:
+//
+//   AI locomotion -+-> AI leg IK ---------+
+//                  +-> AI spatial index --+--> collisions -> AI pose evaluation
+//   player update ------------------------+
+//
+// run() returns once every task has finished, so the caller can submit the
+// GL draws single-threaded from getAIPoses().
+class FramePipeline {
+public:
+    FramePipeline(World& world, JobSystem& jobs, bool evaluatePoses = true);
+
+    CollisionEvents run(float time, float deltaTime);
+
+    // One gathered SpiderState per AI spider, valid until the next run()
+    const std::vector<spider::SpiderState>& getAIPoses() const;
+    // The poses of the run() before, for interpolating between the last two ticks
+    const std::vector<spider::SpiderState>& getPreviousAIPoses() const;
+
+private:
+    void buildGraph();
+
+    World& world_;
+    JobSystem& jobs_;
+    TaskGraph graph_;
+    bool evaluatePoses_;
+
+    // Inputs and outputs of the frame currently running
+    float time_;
+    float deltaTime_;
+    CollisionEvents collisions_;
+    std::vector<spider::SpiderState> aiPoses_;
+    std::vector<spider::SpiderState> previousAIPoses_;
+};
+
+#endif // FRAME_PIPELINE_H
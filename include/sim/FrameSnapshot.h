@@ -0,0 +1,58 @@
+// Description: Header file for the per-frame snapshot the simulation hands to the render thread.
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "../external/Angel/inlcude/Angel/Angel.h"
+#include "obstacle/Obstacle.h"
+#include "spider/SpiderState.h"
+#include "utils/DrawStats.h"
+#include "utils/GpuTimer.h"
+#include "utils/RenderQueue.h"
+
+// Everything the render thread reads for one frame. The simulation fills it,
+// publishes it and never touches it again, so the renderer needs no locks and
+// no access to World.
+struct FrameSnapshot {
+    uint64_t frame = 0;
+
+    mat4 view;
+    int framebufferHeight = 0;
+
+    spider::SpiderState player;
+    std::vector<spider::SpiderState> aiPoses;
+    std::vector<ObstacleDraw> obstacles;
+    int score = 0;
+
+    // Render path switches, read from the keyboard on the simulation thread
+    bool drawAIInstanced = true;
+    bool gpuLegs = true;
+};
+
+// Sent back from the render thread, newest wins. The busy totals only grow,
+// so the reader can diff two reports over any window.
+struct RenderReport {
+    uint64_t frame = 0;
+    uint64_t framesRendered = 0;
+    double busySeconds = 0.0;   // acquire to swap, summed over every rendered frame
+    DrawStats drawStats = DrawStats();
+    RenderQueueStats queueStats = RenderQueueStats();
+    bool gpuTimed = false;
+    size_t gpuDroppedFrames = 0;
+    GpuPassStats gpuPasses[GPU_PASS_COUNT] = {};
+};
+
+// How much of the shorter stage ran hidden behind the longer one over a window
+// of wallSeconds: 0 when the stages ran back to back, 1 when the shorter one
+// overlapped completely.
+inline double overlapEfficiency(double simSeconds, double renderSeconds, double wallSeconds) {
+    double shorter = simSeconds < renderSeconds ? simSeconds : renderSeconds;
+    if (shorter <= 0.0) {
+        return 0.0;
+    }
+    double hidden = (simSeconds + renderSeconds - wallSeconds) / shorter;
+    return hidden < 0.0 ? 0.0 : (hidden > 1.0 ? 1.0 : hidden);
+}
+
+#endif // FRAME_SNAPSHOT_H
@@ -0,0 +1,23 @@
+// Description: Header file for the headless runner, which steps the World without a window or GL context.
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <cstdint>
+#include <string>
+#include "global/GlobalConfig.h"
+
+struct HeadlessOptions {
+    int ticks = 10000;        // number of simulation ticks to run
+    float tickRate = SIM_DEFAULT_TICK_RATE;   // ticks per simulated second
+    int threads = 0;          // job system workers, 0 picks one per spare hardware thread
+    uint32_t seed = 0;        // srand() seed the world is built from
+    std::string replayPath;   // input log to play back; its seed, tick rate and length replace the above
+};
+
+// Steps the AI spiders, the player and the collision sweeps at a fixed tick
+// and prints throughput and World::stateHash. With a replay the player is
+// driven by the logged input, so the run ends on the recorded state.
+// Returns the process exit code.
+int runHeadless(const HeadlessOptions& options);
+
+#endif // HEADLESS_H
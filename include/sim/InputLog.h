@@ -0,0 +1,49 @@
+// Description: Header file for the input log that records a windowed run so it can be replayed headless.
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "global/GlobalConfig.h"
+
+namespace spider {
+    class Spider;
+}
+
+// Player controls held during one simulation tick, one bit each
+enum PlayerInput : uint8_t {
+    PLAYER_INPUT_FORWARD    = 1 << 0,
+    PLAYER_INPUT_BACKWARD   = 1 << 1,
+    PLAYER_INPUT_TURN_LEFT  = 1 << 2,
+    PLAYER_INPUT_TURN_RIGHT = 1 << 3,
+    PLAYER_INPUT_BODY_UP    = 1 << 4,
+    PLAYER_INPUT_BODY_DOWN  = 1 << 5,
+    PLAYER_INPUT_JUMP       = 1 << 6
+};
+
+// Applies one tick's controls to the player: forward wins over backward and
+// body up over body down, as on the keyboard. Both the windowed loop and the
+// replay go through here, so a replayed tick sees exactly the recorded input.
+void applyPlayerInput(spider::Spider& player, uint8_t input);
+
+// Everything that decides a run's simulation: the seed the world's rand() calls
+// start from, the tick rate and the player input of every tick. Frame times are
+// not needed; with the fixed timestep they only decide how ticks are grouped
+// into frames, which the simulation never sees.
+struct InputLog {
+    uint32_t seed = 0;
+    float tickRate = SIM_DEFAULT_TICK_RATE;
+    std::vector<uint8_t> ticks;   // one PlayerInput mask per tick
+};
+
+// Binary, little endian: "SPIL", version (u32), seed (u32), tick rate (f32),
+// tick count (u64), then (mask u8, run length u32) pairs covering every tick.
+// Held keys change rarely, so minutes of play take a few hundred bytes.
+bool writeInputLog(const std::string& path, const InputLog& log);
+
+// False if the file cannot be read, is not an input log of this version, or
+// holds a tick rate that is not finite and positive or more than INT_MAX ticks
+bool readInputLog(const std::string& path, InputLog& log);
+
+#endif // INPUT_LOG_H
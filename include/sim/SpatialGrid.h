@@ -0,0 +1,52 @@
+// Description: Header file for SpatialGrid, a hashed uniform grid over the XZ ground plane.
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Indexes entities by dense id (their index in the owning container) and
+// answers radius queries by visiting only the cells the query circle touches.
+// Insert, move and remove are O(1): every id remembers its cell and its slot
+// in that cell, and cells remove by swap-and-pop.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 2.0f);
+
+    void clear();
+    size_t size() const;
+
+    void insert(uint32_t id, float x, float z);
+    // Updates the stored position; only touches the cells when the id changes cell
+    void update(uint32_t id, float x, float z);
+    void remove(uint32_t id);
+    // Gives the entry of `from` the id `to`, for containers that remove by swap-and-pop
+    void relabel(uint32_t from, uint32_t to);
+
+    // Appends every id within `radius` of (x, z) on the ground plane to `result`.
+    // Callers that need a 3D distance filter the result; it is a superset.
+    void queryRadius(float x, float z, float radius, std::vector<uint32_t>& result) const;
+
+private:
+    struct Entry {
+        uint64_t cell;
+        uint32_t slot;   // index inside cells_[cell]
+        float x, z;
+        bool present;
+    };
+
+    uint64_t cellKey(int cx, int cz) const;
+    int cellCoord(float value) const;
+    void link(uint32_t id, uint64_t cell);
+    void unlink(uint32_t id);
+
+    float cellSize_;
+    float inverseCellSize_;
+    size_t count_;
+    std::vector<Entry> entries_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+};
+
+#endif // SPATIAL_GRID_H
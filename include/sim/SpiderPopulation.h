@@ -0,0 +1,87 @@
+// Description: Header file for SpiderPopulation, a structure-of-arrays store for the AI spiders, and the systems that update it.
+#ifndef SPIDER_POPULATION_H
+#define SPIDER_POPULATION_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "spider/LegIKSolver.h"
+#include "spider/SpiderState.h"
+
+// Locomotion flags, one byte per spider
+enum LocomotionFlags : uint8_t {
+    LOCOMOTION_WALK_FORWARD  = 1 << 0,
+    LOCOMOTION_WALK_BACKWARD = 1 << 1,
+    LOCOMOTION_TURN_LEFT     = 1 << 2,
+    LOCOMOTION_TURN_RIGHT    = 1 << 3
+};
+
+// AI spiders stored component by component. Each array has one entry per
+// spider (jointAngles has LEG_COUNT * LEG_SEGMENT_COUNT), so a system only
+// touches the components it needs and the loops stay contiguous.
+class SpiderPopulation {
+public:
+    SpiderPopulation();
+
+    size_t size() const;
+    bool empty() const;
+    void reserve(size_t count);
+    void clear();
+
+    // Adds a spider at rest and returns its index
+    size_t spawn(const vec3& position, float scale);
+    // O(1): the last spider is moved into `index`, so only that one changes index
+    void remove(size_t index);
+
+    vec3 getPosition(size_t index) const;
+    float* jointAnglesOf(size_t index);
+    const float* jointAnglesOf(size_t index) const;
+
+    // Gathers one spider into the layout SpiderRenderer draws
+    spider::SpiderState stateAt(size_t index) const;
+
+    // Transform
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> yaw;     // in degrees
+    std::vector<float> scale;
+
+    // Locomotion
+    std::vector<uint8_t> locomotion;
+    std::vector<float> steerPhase;   // seconds added to the steering clock, fixed at spawn
+
+    // Gait phase
+    std::vector<float> legAnimationCycle;
+    std::vector<float> abdomenShakeCycle;
+
+    // Joint angles, spider-major then leg-major
+    std::vector<float> jointAngles;
+
+    // Body height the joint angles were last solved for; NaN until the first solve.
+    // legIKSystem skips spiders whose height still matches.
+    std::vector<float> ikSolvedHeight;
+
+    // Changes the solver of one leg slot and marks every spider for a re-solve
+    void setLegIKMethod(int leg, spider::LegIKMethod method);
+    // Forces the next legIKSystem pass to solve every spider again
+    void invalidateIK();
+
+    // IK solver per leg slot, shared by every spider (CCD by default). Change it
+    // through setLegIKMethod so cached poses are re-solved.
+    spider::LegIKMethod legIKMethods[LEG_COUNT];
+};
+
+// Systems, run in this order by World::updateAISpiders. Each one takes a
+// [begin, end) range of spiders so it can be split across worker threads.
+
+// Walk forward and alternate turning direction every two seconds, offset per spider
+void steerSystem(SpiderPopulation& population, float time, size_t begin, size_t end);
+// Integrates yaw and position from the locomotion flags
+void locomotionSystem(SpiderPopulation& population, float deltaTime, size_t begin, size_t end);
+// Advances the leg swing and abdomen shake cycles of moving spiders
+void gaitSystem(SpiderPopulation& population, float deltaTime, size_t begin, size_t end);
+// Solves leg IK for spiders whose body height changed since their last solve:
+// through the shared LegIKCache when it is enabled, otherwise warm-started from
+// their current joint angles
+void legIKSystem(SpiderPopulation& population, size_t begin, size_t end);
+
+#endif // SPIDER_POPULATION_H
@@ -0,0 +1,70 @@
+// Description: Header file for the World class, holding the simulation state shared by the windowed and headless modes.
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+#include "spider/Spider.h"
+#include "obstacle/Obstacle.h"
+#include "sim/SpiderPopulation.h"
+#include "sim/SpatialGrid.h"
+
+class JobSystem;
+
+const int DEFAULT_AI_SPIDER_COUNT = 50;
+const int DEFAULT_OBSTACLE_COUNT = 10;
+
+// What happened during one collision sweep, so callers can react (window title, logs)
+struct CollisionEvents {
+    int obstaclesHit = 0;
+    int spidersEaten = 0;
+};
+
+// The player, the AI spiders and the obstacles. Nothing in here needs a GL
+// context, so the same world can be stepped by main's render loop or headless.
+class World {
+public:
+    World();
+
+    void initAISpiders(int count = DEFAULT_AI_SPIDER_COUNT);
+    void setupObstacles(GLuint shaderProgram, int count = DEFAULT_OBSTACLE_COUNT);
+
+    // Fills the shared LegIKCache for every leg over the legal body-height range
+    // (BODY_MIN_Y..BODY_MAX_Y), so per-frame IK becomes a table lookup. No-op when
+    // the cache is disabled.
+    void precomputeLegIK();
+
+    // Runs the steering, locomotion, gait and leg IK systems over the AI population
+    void updateAISpiders(float time, float deltaTime);
+
+    // The two halves of updateAISpiders, split across the job system's workers
+    void updateAILocomotion(JobSystem& jobs, float time, float deltaTime);
+    void solveAILegIK(JobSystem& jobs);
+
+    // Moves AI spiders that changed cell after locomotion; serial, touches only the grid
+    void updateAISpatialIndex();
+
+    // Player vs obstacles and player vs AI spiders; updates score, growth and respawns.
+    // Only entities in the grid cells around the player are tested.
+    CollisionEvents checkCollisions();
+
+    // FNV-1a over the player, the AI spiders, the obstacles and the score. Two runs
+    // with the same seed and inputs must end on the same value; used to check replays.
+    uint64_t stateHash() const;
+
+    // O(1) swap-and-pop removals that keep the spatial grids in sync
+    void removeAISpider(size_t index);
+    void removeObstacle(size_t index);
+
+    spider::Spider player;
+    SpiderPopulation aiSpiders;
+    std::vector<Obstacle> obstacles;
+    int score;
+
+    // Spatial indexes over aiSpiders and obstacles, keyed by their index
+    SpatialGrid aiSpiderGrid;
+    SpatialGrid obstacleGrid;
+};
+
+#endif // WORLD_H
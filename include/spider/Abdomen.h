@@ -2,49 +2,44 @@
 #include <GL/glew.h>
 #include "../external/Angel/inlcude/Angel/Angel.h"
 #include <vector>
+#include "spider/MeshRegistry.h"
+#include "global/GlobalConfig.h"
 
 namespace spider {
 
     class Abdomen {
     public:
         explicit Abdomen(GLuint shaderProgram);
-        ~Abdomen();
 
-        // Draws the abdomen using the currently bound shader/program
-        void draw(GLuint modelViewLoc, GLuint projectionLoc,
-                  const mat4& modelMatrix, const mat4& P) const;
+        Abdomen(const Abdomen&) = delete;
+        Abdomen& operator=(const Abdomen&) = delete;
+        Abdomen(Abdomen&&) = default;
+        Abdomen& operator=(Abdomen&&) = default;
 
-    private:
-        GLuint  _vao = 0;
-        GLuint  _vbo = 0;
-        GLuint  _ebo = 0;
-        GLsizei _indexCount = 0;
-        GLuint _program = 0;
+        // Draws the abdomen using the currently bound shader/program
+        void draw(GLuint modelLoc, const mat4& modelMatrix) const;
 
-        // Initializes the entire mesh process
-        void initMesh();
+        const MeshHandle& getMesh(int lod = 0) const;
 
-        // Generates the vertex positions and normals
-        void generateVertices(
+        // Generates the vertex positions and normals; needs no GL context
+        static void generateVertices(
             int stacks, int slices,
             float radiusX, float radiusY, float radiusZ,
             std::vector<GLfloat>& interleavedData
         );
 
+    private:
+        MeshHandle _meshes[MESH_LOD_COUNT];   // one per level of detail, shared with every other abdomen
+        GLuint _program = 0;
+
+        // Initializes the entire mesh process
+        void initMesh();
+
         // Generates the indices for triangle faces
-        void generateIndices(
+        static void generateIndices(
             int stacks, int slices,
             std::vector<GLuint>& indices
         );
-
-        // Uploads mesh data to the GPU
-        void uploadToGPU(
-            const std::vector<GLfloat>& interleavedData,
-            const std::vector<GLuint>& indices
-        );
-
-        // Releases GPU resources
-        void cleanup();
     };
 
 } // namespace spider
\ No newline at end of file
@@ -1,43 +1,59 @@
 #pragma once
 #include <GL/glew.h>
 #include "../external/Angel/inlcude/Angel/Angel.h"
+#include <array>
 #include <vector>
+#include "global/GlobalConfig.h"
+#include "spider/MeshRegistry.h"
 
 namespace spider {
 
+    // Where the other parts mount on the body, in cephalothorax space (eyeAnchor in head space).
+    // Derived from the undisplaced surfaces once, so it never depends on a mesh instance.
+    struct SpiderRig {
+        std::array<vec3, LEG_COUNT> legAttachments;   // left, right, left, ... from back to front
+        vec3 headAnchor;                              // front-most point of the body
+        vec3 eyeAnchor;                               // front-most point of the head
+        float boundingRadius;                         // sphere around the origin holding body and stretched legs
+    };
+
     class Cephalothorax {
     public:
         explicit Cephalothorax(GLuint shaderProgram);
-        ~Cephalothorax();
 
-        void draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& modelMatrix, const mat4& P) const;
+        Cephalothorax(const Cephalothorax&) = delete;
+        Cephalothorax& operator=(const Cephalothorax&) = delete;
+        Cephalothorax(Cephalothorax&&) = default;
+        Cephalothorax& operator=(Cephalothorax&&) = default;
+
+        // modelMatrix is the world transform; view and projection come from the Camera block
+        void draw(GLuint modelLoc, const mat4& modelMatrix) const;
+
+        const MeshHandle& getMesh(int lod = 0) const;
 
         // Getters for leg attachment points and head anchor point
-        const std::vector<vec3>& getVertexPositions() const;
-        std::vector<vec3> getLegAttachmentPoints() const;
-        vec3 getHeadAnchorPoint() const;
+        const std::array<vec3, LEG_COUNT>& getLegAttachmentPoints() const;
+        const vec3& getHeadAnchorPoint() const;
 
-    private:
-        void initMesh();
-        void cleanup();
+        // The rig of the default body, built on first use without a GL context,
+        // so the simulation and the renderer share one copy.
+        static const SpiderRig& getRig();
+        // Builds the rig from scratch; getRig caches one. Public for spider_bench.
+        static SpiderRig buildRig();
 
-        // Mesh generation helper methods
-        void generateVertexData(int stacks, int slices,
-                              float radiusX, float radiusY, float radiusZ,
-                              std::vector<GLfloat>& interleavedData);
-        void generateIndices(int stacks, int slices, std::vector<GLuint>& indices);
-        void uploadToGPU(const std::vector<GLfloat>& interleavedData,
-                        const std::vector<GLuint>& indices);
+        // Mesh generation helpers, GL-free (initMesh uploads the result)
+        static void generateVertexData(int stacks, int slices,
+                                       float radiusX, float radiusY, float radiusZ,
+                                       std::vector<GLfloat>& interleavedData);
+        static void generateIndices(int stacks, int slices, std::vector<GLuint>& indices);
 
-        std::vector<vec3> _vertexPositions; // only positions, not normals
-        std::vector<vec3> _vertexPositionsNormal; // only positions, not normals
+    private:
+        static std::vector<vec3> selectLegAttachmentPoints(const std::vector<vec3>& restPositions);
 
+        void initMesh();
 
         GLuint _program;
-        GLuint _vao;
-        GLuint _vbo;
-        GLuint _ebo;
-        GLsizei _indexCount;
+        MeshHandle _meshes[MESH_LOD_COUNT];   // one per level of detail, shared with every other cephalothorax
     };
 
 } // namespace spider
\ No newline at end of file
@@ -0,0 +1,20 @@
+// Description: Header file for the noise-displaced ellipsoid shared by the abdomen, cephalothorax and head meshes.
+#ifndef ELLIPSOID_MESH_H
+#define ELLIPSOID_MESH_H
+
+#include <vector>
+
+namespace spider {
+
+    // Appends (stacks + 1) * (slices + 1) interleaved position + normal vertices of
+    // an ellipsoid pushed out along its normal by amplitude * noise(position * frequency).
+    // The noise is evaluated in one batch with its gradient, and each normal is
+    // tilted by the gradient's tangential part so it matches the displaced surface.
+    void generateNoisyEllipsoid(int stacks, int slices,
+                                float radiusX, float radiusY, float radiusZ,
+                                float frequency, float amplitude,
+                                std::vector<float>& interleaved);
+
+} // namespace spider
+
+#endif // ELLIPSOID_MESH_H
@@ -1,24 +1,28 @@
 #pragma once
 #include <GL/glew.h>
 #include "../external/Angel/inlcude/Angel/Angel.h"
+#include "spider/MeshRegistry.h"
+#include "global/GlobalConfig.h"
 
 namespace spider {
 
     class Eye {
     public:
         Eye(GLuint shaderProgram);
-        ~Eye();
 
-        void draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& modelMatrix, const mat4& projMatrix) const;
+        Eye(const Eye&) = delete;
+        Eye& operator=(const Eye&) = delete;
+        Eye(Eye&&) = default;
+        Eye& operator=(Eye&&) = default;
+
+        void draw(GLuint modelLoc, const mat4& modelMatrix) const;
+
+        const MeshHandle& getMesh(int lod = 0) const;
 
     private:
         void initMesh();
-        void cleanup();
 
-        GLuint _vao = 0;
-        GLuint _vbo = 0;
-        GLuint _ebo = 0;
-        GLsizei _indexCount = 0;
+        MeshHandle _meshes[MESH_LOD_COUNT];   // all eyes share one sphere per level of detail
         GLuint _program = 0;
     };
 
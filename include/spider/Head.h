@@ -3,6 +3,8 @@
 #include "../external/Angel/inlcude/Angel/Angel.h"
 #include <vector>
 #include "spider/Eye.h"
+#include "spider/MeshRegistry.h"
+#include "global/GlobalConfig.h"
 
 namespace spider {
 
@@ -10,50 +12,39 @@ namespace spider {
     public:
 
         explicit Head(GLuint shaderProgram);
-        ~Head();
 
-        void draw(GLuint modelViewLoc, GLuint projectionLoc,
-                  const mat4& modelMatrix, const mat4& projMatrix) const;
+        Head(const Head&) = delete;
+        Head& operator=(const Head&) = delete;
+        Head(Head&&) = default;
+        Head& operator=(Head&&) = default;
 
-        // Add this in the public section of the Head class
-        vec3 getMostFrontVertex() const;
+        void draw(GLuint modelLoc, const mat4& modelMatrix) const;
 
-    private:
-        GLuint _vao = 0;
-        GLuint _vbo = 0;
-        GLuint _ebo = 0;
-        GLsizei _indexCount = 0;
-        GLuint _program = 0;
-
-        std::vector<vec3> _vertexPositions;  // surface points
-        std::vector<vec3> _vertexPositionsEye;  // surface points
+        const MeshHandle& getMesh(int lod = 0) const;
 
+        // Front-most point of the undisplaced head surface, nudged outwards; where the eyes sit.
+        // Computed once per process and needs no GL context.
+        static const vec3& getMostFrontVertex();
 
+    private:
+        MeshHandle _meshes[MESH_LOD_COUNT];   // one per level of detail, shared with every other head
+        GLuint _program = 0;
 
         // Initializes the mesh
         void initMesh();
 
         // Generates vertices with normals
-        void generateVertices(
+        static void generateVertices(
             int stacks, int slices,
             float radiusX, float radiusY, float radiusZ,
             std::vector<GLfloat>& interleaved
         );
 
         // Generates indices for triangle faces
-        void generateIndices(
+        static void generateIndices(
             int stacks, int slices,
             std::vector<GLuint>& indices
         );
-
-        // Uploads mesh data to GPU
-        void uploadToGPU(
-            const std::vector<GLfloat>& interleaved,
-            const std::vector<GLuint>& indices
-        );
-
-        // Releases GPU resources
-        void cleanup();
     };
 
 } // namespace spider
\ No newline at end of file
@@ -17,23 +17,29 @@ namespace spider {
 
         // Set the per-joint pitch angle (in degrees) around local X
         void setJointAngles(const std::vector<float>& angles);
+        void setJointAngles(const float* angles, int count);
 
         const std::vector<float>& getJointAngles() const; // Added getter
 
 
-        void draw(GLuint modelViewLoc,
-                  GLuint projectionLoc,
-                  const mat4& modelMatrix,
-                  const mat4& projMatrix);
+        void draw(GLuint modelLoc, const mat4& modelMatrix);
 
         const std::vector<vec3>& getSegmentEnds() const;
 
-        std::vector<float> inverseKinematicsCCD(
+        // Appends the model matrix of every segment cuboid (length and thickness scale
+        // included) for a leg rooted at root and posed with one angle per segment.
+        // With jointStride > 1 every run of that many segments becomes one straight
+        // cuboid from its first joint to its last, for distant spiders.
+        void appendSegmentTransforms(const mat4& root, const float* angles, std::vector<mat4>& out,
+                                     int jointStride = 1) const;
+
+        // Solvers are stateless, so the simulation can run them without a Leg (and its GL geometry)
+        static std::vector<float> inverseKinematicsCCD(
             float x_target, float y_target, float L, int n, int maxIter, float tol,
             const std::vector<float>& theta_min, const std::vector<float>& theta_max
         );
 
-        void forwardKinematics(const std::vector<float>& theta_deg, float L, std::vector<float>& x, std::vector<float>& y);
+        static void forwardKinematics(const std::vector<float>& theta_deg, float L, std::vector<float>& x, std::vector<float>& y);
 
     private:
         std::vector<float>     jointAngles;
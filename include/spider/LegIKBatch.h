@@ -0,0 +1,48 @@
+// Description: Header file for the batched CCD leg solver, which solves many legs in SIMD lockstep.
+#ifndef LEG_IK_BATCH_H
+#define LEG_IK_BATCH_H
+
+#include <cstddef>
+#include "spider/LegKinematics.h"
+
+namespace spider {
+
+    // Inputs and output of one batched solve, in structure-of-arrays layout.
+    // Every leg shares the segment count and length; targets are per leg.
+    struct LegIKBatch {
+        size_t legCount = 0;
+        int segmentCount = 0;
+        float segmentLength = 0.0f;
+        int maxIter = 0;
+        float tolerance = 0.0f;
+
+        const float* targetX = nullptr;     // [legCount]
+        const float* targetY = nullptr;     // [legCount]
+
+        // segmentCount limits per leg, in degrees. limitStride is the distance
+        // between the limits of consecutive legs; 0 makes every leg share one set.
+        const float* thetaMin = nullptr;
+        const float* thetaMax = nullptr;
+        size_t limitStride = 0;
+
+        // Optional starting pose, packed like thetaOut (it may be thetaOut itself);
+        // null starts every joint at zero
+        const float* thetaStart = nullptr;
+
+        // segmentCount angles per leg, legs packed back to back
+        float* thetaOut = nullptr;
+    };
+
+    // Same algorithm as spider::solveCCD, run for simd::WIDTH
+    // legs at a time. Chains longer than LEG_KINEMATICS_MAX_SEGMENTS use the scalar solver. Results match the scalar solver within the solve tolerance; the
+    // only difference is the polynomial atan2/sin/cos in place of libm.
+    // Builds without SSE2/AVX2 (e.g. Apple Silicon) run the scalar solver per leg.
+    void solveLegIKBatch(const LegIKBatch& batch);
+
+    // Lanes per solve and the instruction set they were built for ("AVX2", "SSE2" or "scalar")
+    int legIKBatchWidth();
+    const char* legIKBatchInstructionSet();
+
+} // namespace spider
+
+#endif // LEG_IK_BATCH_H
@@ -0,0 +1,96 @@
+// Description: Header file for LegIKCache, a process-wide memo table of solved leg poses.
+#ifndef LEG_IK_CACHE_H
+#define LEG_IK_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include "spider/LegIKSolver.h"
+#include "spider/LegKinematics.h"
+
+namespace spider {
+
+    struct LegIKCacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t entries;
+    };
+
+    // Every spider has the same legs, so a leg pose depends only on the solver
+    // configuration and the target. The cache keys on (configuration, target
+    // snapped to a grid of `quantum`) and stores the cold-start solution for the
+    // snapped target, which makes a cached pose independent of who asked first.
+    // Lookups lock one of SHARD_COUNT shards, so workers rarely contend.
+    class LegIKCache {
+    public:
+        explicit LegIKCache(float quantum = 0.001f, bool enabled = true);
+
+        LegIKCache(const LegIKCache&) = delete;
+        LegIKCache& operator=(const LegIKCache&) = delete;
+
+        // The shared table used by the simulation, configured from GlobalConfig
+        static LegIKCache& instance();
+
+        bool isEnabled() const;
+        void setEnabled(bool enabled);
+
+        // Changing the grid drops every entry. Not safe while other threads look up.
+        void setQuantum(float quantum);
+        float getQuantum() const;
+
+        // Writes the pose for the problem's snapped target into thetaDeg, solving
+        // from the zero pose and storing it on a miss. The returned residual is
+        // against the snapped target. Chains longer than LEG_KINEMATICS_MAX_SEGMENTS
+        // are solved directly and not stored.
+        LegIKResult solve(LegIKMethod method, const LegIKProblem& problem, float* thetaDeg);
+
+        // Fills every grid step of targetY in [minTargetY, maxTargetY] at the problem's targetX
+        void precompute(LegIKMethod method, const LegIKProblem& problem, float minTargetY, float maxTargetY);
+
+        LegIKCacheStats getStats() const;
+        void resetStats();
+        void clear();
+
+    private:
+        static const size_t SHARD_COUNT = 16;
+
+        struct Key {
+            uint64_t config;
+            int32_t x;
+            int32_t y;
+            bool operator==(const Key& other) const {
+                return config == other.config && x == other.x && y == other.y;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct Entry {
+            std::array<float, LEG_KINEMATICS_MAX_SEGMENTS> angles;
+            float residual;
+        };
+
+        struct Shard {
+            mutable std::mutex mutex;
+            std::unordered_map<Key, Entry, KeyHash> entries;
+        };
+
+        static uint64_t configHash(LegIKMethod method, const LegIKProblem& problem);
+        Key makeKey(LegIKMethod method, const LegIKProblem& problem) const;
+        Shard& shardFor(const Key& key);
+
+        Shard shards_[SHARD_COUNT];
+        float quantum_;
+        std::atomic<bool> enabled_;
+        std::atomic<uint64_t> hits_;
+        std::atomic<uint64_t> misses_;
+    };
+
+} // namespace spider
+
+#endif // LEG_IK_CACHE_H
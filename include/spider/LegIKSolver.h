@@ -0,0 +1,66 @@
+// Description: Header file for the interchangeable leg IK solvers (CCD, FABRIK and a closed-form two-bone solver).
+#ifndef LEG_IK_SOLVER_H
+#define LEG_IK_SOLVER_H
+
+#include <cstdint>
+
+namespace spider {
+
+    enum class LegIKMethod {
+        CCD,        // cyclic coordinate descent, the default
+        FABRIK,     // forward and backward reaching on joint positions, limits applied per pass
+        TwoBone     // closed form: the chain is folded into two rigid bones around joints 0 and 3
+    };
+
+    const int LEG_IK_METHOD_COUNT = 3;
+
+    // One planar chain rooted at the origin, angles in degrees
+    struct LegIKProblem {
+        float targetX;
+        float targetY;
+        float segmentLength;
+        int segmentCount;
+        int maxIter;
+        float tolerance;
+        const float* thetaMin;
+        const float* thetaMax;
+        // Optional angles for the joints a reduced-DOF solver does not move; null keeps the incoming pose
+        const float* restPose = nullptr;
+    };
+
+    struct LegIKResult {
+        int iterations;     // sweeps run; closed-form solvers report 1
+        float residual;     // end effector distance to the target after solving
+    };
+
+    class LegIKSolver {
+    public:
+        virtual ~LegIKSolver() {}
+
+        virtual LegIKMethod getMethod() const = 0;
+        virtual const char* getName() const = 0;
+
+        // thetaDeg holds the starting pose on input and the solved pose on output
+        virtual LegIKResult solve(const LegIKProblem& problem, float* thetaDeg) const = 0;
+    };
+
+    // Stateless solver instances, safe to share between threads
+    const LegIKSolver& getLegIKSolver(LegIKMethod method);
+
+    // Distance from the chain's end effector to the problem's target
+    float legIKResidual(const LegIKProblem& problem, const float* thetaDeg);
+
+    // Process-wide tally of leg solves that ran versus ones skipped because their inputs
+    // had not changed since the last solve. Safe to record from worker threads.
+    struct LegIKCounters {
+        uint64_t executed;
+        uint64_t skipped;
+    };
+
+    void recordLegIKSolves(uint64_t executed, uint64_t skipped);
+    LegIKCounters getLegIKCounters();
+    void resetLegIKCounters();
+
+} // namespace spider
+
+#endif // LEG_IK_SOLVER_H
@@ -0,0 +1,24 @@
+// Description: Header file for the planar leg kinematics shared by Leg, the batched solver and the benchmarks.
+#ifndef LEG_KINEMATICS_H
+#define LEG_KINEMATICS_H
+
+namespace spider {
+
+    // Chains up to this length are solved with stack buffers
+    const int LEG_KINEMATICS_MAX_SEGMENTS = 16;
+
+    // Joint positions of an n-segment planar chain rooted at the origin.
+    // thetaDeg holds relative joint angles in degrees; x and y receive n + 1 points.
+    void forwardKinematics(const float* thetaDeg, int n, float L, float* x, float* y);
+
+    // Cyclic coordinate descent towards (xTarget, yTarget). thetaDeg is the
+    // starting pose on input and the solved pose on output. Rotating joint i
+    // only rotates the points downstream of it, so a sweep costs one sin/cos
+    // pair per joint instead of a full forward pass per joint.
+    // Returns the number of sweeps run before the tolerance was met.
+    int solveCCD(float xTarget, float yTarget, float L, int n, int maxIter, float tol,
+                 const float* thetaMin, const float* thetaMax, float* thetaDeg);
+
+} // namespace spider
+
+#endif // LEG_KINEMATICS_H
@@ -1,6 +1,7 @@
 #pragma once
 #include <GL/glew.h>
 #include "../external/Angel/inlcude/Angel/Angel.h"
+#include "spider/MeshRegistry.h"
 
 namespace spider {
 
@@ -9,6 +10,7 @@ namespace spider {
     public:
         static void initSharedGeometry(GLuint shaderProgram, float canonicalThickness = 0.05f);
         static void cleanupShared();
+        static const MeshHandle& getSharedMesh();   // empty until initSharedGeometry
 
         LegSegment(float length = 0.4f, float thickness = 0.05f);
 
@@ -19,21 +21,14 @@ namespace spider {
         float  getThickness()  const;
 
 
-        void draw(GLuint modelViewLoc,
-                  GLuint projectionLoc,
-                  const mat4& modelMatrix,
-                  const mat4& projMatrix) const;
+        void draw(GLuint modelLoc, const mat4& modelMatrix) const;
 
     private:
         float  m_length;
         float  m_thickness;
 
         static GLuint s_program;
-        static GLuint s_vao;
-        static GLuint s_vbo;
-        static GLuint s_ebo;
-        static GLsizei s_indexCount;
-        static bool s_initialized;
+        static MeshHandle s_mesh;
     };
 
 } // namespace spider
@@ -0,0 +1,104 @@
+// Description: Header file for MeshRegistry, which builds each body-part mesh once and shares it.
+#ifndef MESH_REGISTRY_H
+#define MESH_REGISTRY_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "utils/GLHandle.h"
+
+namespace spider {
+
+    enum class MeshPart {
+        Cephalothorax,
+        Abdomen,
+        Head,
+        Eye,
+        LegSegment
+    };
+
+    // Everything that changes the generated geometry. Two parts asking with
+    // equal keys get the same mesh.
+    struct MeshKey {
+        MeshPart part;
+        int stacks;
+        int slices;
+        float radiusX;
+        float radiusY;
+        float radiusZ;
+        float noiseScale;
+        float noiseStrength;
+
+        bool operator==(const MeshKey& other) const;
+    };
+
+    // CPU-side output of a mesh builder; freed once the data is on the GPU.
+    // Vertices are interleaved: position, then a normal when floatsPerVertex is 6.
+    struct MeshData {
+        std::vector<GLfloat> vertices;
+        std::vector<GLuint> indices;
+        int floatsPerVertex = 6;
+    };
+
+    // Immutable GPU mesh. The buffers are deleted with the last handle.
+    struct Mesh {
+        GLVertexArray vao;
+        GLBuffer vbo;
+        GLBuffer ebo;
+        GLsizei indexCount = 0;
+        int floatsPerVertex = 6;
+        size_t gpuBytes = 0;
+    };
+
+    typedef std::shared_ptr<const Mesh> MeshHandle;
+
+    // Binds the mesh's vertex and index buffers to the currently bound VAO and
+    // points attribute 0 (position) and, if present, 1 (normal) at them
+    void bindMeshVertexLayout(const Mesh& mesh);
+
+    struct MeshRegistryStats {
+        size_t meshes;      // meshes currently alive
+        size_t builds;      // meshes generated and uploaded since start
+        size_t reuses;      // acquire calls answered with an existing mesh
+        size_t gpuBytes;    // vertex and index buffers of the live meshes
+        size_t cpuBytes;    // registry and mesh bookkeeping kept on the CPU
+    };
+
+    // Flyweight store for spider geometry. The registry only holds weak
+    // references, so a mesh lives exactly as long as some part draws with it.
+    // Must be used from the thread that owns the GL context.
+    class MeshRegistry {
+    public:
+        typedef std::function<void(MeshData&)> Builder;
+
+        MeshRegistry(const MeshRegistry&) = delete;
+        MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+        static MeshRegistry& instance();
+
+        // Returns the mesh for key, running build and uploading its output only
+        // when no live mesh has that key
+        MeshHandle acquire(const MeshKey& key, const Builder& build);
+
+        MeshRegistryStats getStats() const;
+
+    private:
+        MeshRegistry();
+
+        struct Entry {
+            MeshKey key;
+            std::weak_ptr<const Mesh> mesh;
+        };
+
+        static std::shared_ptr<Mesh> upload(const MeshData& data);
+
+        std::vector<Entry> entries_;
+        size_t builds_;
+        size_t reuses_;
+    };
+
+} // namespace spider
+
+#endif // MESH_REGISTRY_H
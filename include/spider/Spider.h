@@ -2,22 +2,26 @@
 #ifndef SPIDER_H
 #define SPIDER_H
 
-#include <MacTypes.h>
-
-#include "Cephalothorax.h"
-#include "Abdomen.h"
-#include "Head.h"
-#include "Eye.h"
+#include "SpiderState.h"
 #include "Leg.h"
+#include "LegIKSolver.h"
 #include <vector>
 #include <string>
 
 namespace spider {
 
+    // Simulation-only spider. Owns no GL resources; drawing is done by SpiderRenderer.
     class Spider {
 
     public:
-        Spider(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader);
+        Spider();
+
+        // One spider per simulated body; hand it over by moving
+        Spider(const Spider&) = delete;
+        Spider& operator=(const Spider&) = delete;
+        Spider(Spider&&) = default;
+        Spider& operator=(Spider&&) = default;
+
         void setPosition(const vec3& pos);
         const vec3& getPosition() const;
         void setScale(float scale);
@@ -34,62 +38,41 @@ namespace spider {
 
         void update(float deltaTime);
 
-        void applyIKToAllLegs(std::vector<Leg*>& legs,
-                                      const std::vector<Angel::vec3>& targets,
-                                      float param1, int param2, int param3,
-                                      float param4,
-                                      const std::vector<std::vector<float>>& matrix1,
-                                      const std::vector<std::vector<float>>& matrix2);
-
-        void draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& viewMatrix, const mat4& projMatrix);
-
-        void drawAllComponents(GLuint cephMVLoc, GLuint cephPLoc, GLuint abdMVLoc, GLuint abdPLoc, GLuint legMVLoc,
-                               GLuint legPLoc, GLuint eyeMVLoc, GLuint eyePLoc, const mat4 &viewMatrix,
-                               const mat4 &projMatrix);
+        // Solves every leg, warm-started from the current joint angles
+        void applyIKToAllLegs(const std::vector<Angel::vec3>& targets,
+                              float param1, int param2, int param3,
+                              float param4,
+                              const std::vector<std::vector<float>>& matrix1,
+                              const std::vector<std::vector<float>>& matrix2);
 
-        const std::vector<vec3>& getInitialLegTipGroundContacts() const;
-        Leg leg, leg2, leg3, leg4, leg5, leg6, leg7, leg8;
-        Cephalothorax cephalothorax;
+        const SpiderState& getState() const;
 
-        bool jumpTriggered; // Global flag to trigger jump
+        // Which IK solver drives each leg; every leg starts on CCD
+        void setLegIKMethod(int leg, LegIKMethod method);
+        LegIKMethod getLegIKMethod(int leg) const;
 
         std::vector<std::pair<float, float>> getXYLengthsForAllAttachments(const std::vector<vec3>& attachPoints);
 
         void moveBodyUp();
         void moveBodyDown();
 
+        void triggerJump();
+        bool isJumpTriggered() const;
         void jump(float deltaTime, float jumpDuration);
 
     private:
-        void calculateAndStoreInitialLegTipGroundContacts();
+        // Re-solves every leg against the current body height with the GlobalConfig IK settings,
+        // unless the height is the one the legs were last solved for
+        void solveLegIK();
 
-
-        Abdomen abdomen;
-        Head head;
-        Eye leftEye, rightEye, leftEye2, rightEye2;
-
-        GLuint _shaderProgram;
-        vec3 position;
-        vec3 current_forward_vector_;
-
-        bool is_walking_forward_;
-        bool is_walking_backward_;
-        bool is_turning_left_;
-        bool is_turning_right_;
+        SpiderState state_;
+        LegIKMethod leg_ik_methods_[LEG_COUNT];
+        float ik_solved_height_;   // NaN until the first solve and after a solver change
 
         float walk_speed_;
         float turn_speed_;
-        float current_yaw_angle_;
-    float scale_ = 1.0f;
-
-        float leg_animation_cycle_;
         float leg_animation_speed_;
-        float max_leg_swing_angle_;
-
-        float base_abdomen_tilt_angle_;
-        float abdomen_shake_cycle_;
         float abdomen_shake_speed_;
-        float max_abdomen_shake_amplitude_;
 
     };
 
@@ -0,0 +1,138 @@
+// Description: Header file for the SpiderRenderer class, which owns the GL meshes of a spider.
+#ifndef SPIDER_RENDERER_H
+#define SPIDER_RENDERER_H
+
+#include "Cephalothorax.h"
+#include "Abdomen.h"
+#include "Head.h"
+#include "Eye.h"
+#include "Leg.h"
+#include "SpiderState.h"
+#include "MeshRegistry.h"
+#include "utils/GLHandle.h"
+#include "utils/RenderQueue.h"
+#include "utils/ViewFrustum.h"
+#include <cstdint>
+#include <vector>
+
+namespace spider {
+
+    // Draws any number of spiders from their simulation state. One renderer is
+    // created once a GL context exists and shared by the player and the AI spiders.
+    class SpiderRenderer {
+
+    public:
+        SpiderRenderer(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader);
+
+        // Bounding sphere: the rig radius (body plus stretched legs) times the spider's scale
+        static bool isVisible(const SpiderState& state, const ViewFrustum& frustum);
+        // Level of detail for a bounding sphere covering screenRadius pixels, moving
+        // away from previousLod only once the radius is LOD_HYSTERESIS past a threshold
+        static int selectLod(float screenRadius, int previousLod);
+
+        // Copies the states that pass isVisible into visible (both cleared first) and
+        // appends each one's level of detail to lods. The previous level is remembered
+        // per index of states, so spiders keep their level while the list is stable.
+        void selectVisible(const std::vector<SpiderState>& states, const ViewFrustum& frustum,
+                           const mat4& viewMatrix, const mat4& projMatrix, float viewportHeight,
+                           std::vector<SpiderState>& visible, std::vector<int>& lods);
+
+        // Pushes one packet per body part and leg segment; the queue groups them
+        // by program and mesh across all spiders. legSwingCycles scales how many
+        // leg swings one animation cycle makes (the player uses half the AI rate).
+        void enqueue(const SpiderState& state, RenderQueue& queue, int lod = 0, float legSwingCycles = 1.0f);
+
+        // The instanced path needs programs linked from spider_instanced_vertex.glsl
+        // and each part's fragment shader (the head shares the cephalothorax one)
+        void enableInstancing(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader);
+        bool isInstancingEnabled() const;
+
+        // Draws every state like enqueue, but with one glDrawElementsInstanced
+        // per body part and level of detail for the whole list
+        void drawInstanced(const std::vector<SpiderState>& states, const std::vector<int>& lods);
+
+        // Leg mode for drawInstanced: each spider uploads only its transform, swing and
+        // joint angles, and leg_fk_vertex.glsl rebuilds every segment from gl_InstanceID,
+        // so all legs of all spiders are one draw. Needs a program linked from
+        // leg_fk_vertex.glsl and the leg fragment shader; active once enabled.
+        void enableGpuLegs(GLuint legFKShader);
+        void setGpuLegsActive(bool active);
+        bool isGpuLegsActive() const;
+
+        // Spider-space placement of every part, shared by the per-part and instanced paths
+        struct PartTransforms {
+            mat4 cephalothorax;
+            mat4 abdomen;
+            mat4 head;
+            mat4 eyes[4];             // left, right, lower left, lower right
+            mat4 legRoots[LEG_COUNT];
+        };
+
+        // Pure matrix work, no GL calls; spider_bench times it without a renderer
+        static void computePartTransforms(const SpiderState& state, PartTransforms& out, float legSwingCycles = 1.0f);
+
+    private:
+
+        // Indexes the per-part tables of both the queued and the instanced path
+        enum InstancedPart {
+            INSTANCED_CEPHALOTHORAX,
+            INSTANCED_ABDOMEN,
+            INSTANCED_HEAD,
+            INSTANCED_EYE,
+            INSTANCED_LEG_SEGMENT,
+            INSTANCED_PART_COUNT
+        };
+
+        // One shared mesh drawn once per instance transform
+        struct InstancedBatch {
+            MeshHandle mesh;
+            GLuint program = 0;
+            GLVertexArray vao;
+            GLBuffer instanceBuffer;
+            std::vector<mat4> transforms;
+        };
+
+        // What the render queue needs to draw one part
+        struct QueuedPart {
+            MeshHandle mesh;
+            GLuint program = 0;
+            GLint modelLoc = -1;
+        };
+
+        // Joint angles and per-spider parameters in a texture buffer
+        struct GpuLegBatch {
+            GLuint program = 0;
+            GLint dataLoc = -1;
+            GLint firstSpiderLoc = -1;
+            GLint jointStrideLoc = -1;
+            GLVertexArray vao;
+            GLBuffer dataBuffer;
+            GLTexture dataTexture;
+            std::vector<GLfloat> records;
+            std::vector<size_t> order;   // state index of each record
+        };
+
+        static float legSwingAngle(const SpiderState& state, float legSwingCycles = 1.0f);
+        static void queuePart(RenderQueue& queue, const QueuedPart& part, const mat4& model);
+        void flushInstanced(InstancedBatch& batch);
+        void drawGpuLegs(const std::vector<SpiderState>& states, const std::vector<int>& lods);
+
+        Cephalothorax cephalothorax;
+        Abdomen abdomen;
+        Head head;
+        Eye leftEye, rightEye, leftEye2, rightEye2;
+        std::vector<Leg> legs;
+
+        QueuedPart queued_[INSTANCED_PART_COUNT][MESH_LOD_COUNT];
+        std::vector<mat4> legTransforms_;
+        // Leg segments only use level 0: fewer segments, same cuboid
+        InstancedBatch instanced_[INSTANCED_PART_COUNT][MESH_LOD_COUNT];
+        std::vector<uint8_t> lodHistory_;
+        bool instancingEnabled_;
+        GpuLegBatch gpuLegs_;
+        bool gpuLegsActive_;
+    };
+
+} // namespace spider
+
+#endif // SPIDER_RENDERER_H
@@ -0,0 +1,43 @@
+// Description: Plain simulation data for one spider, shared by Spider::update and the renderer.
+#pragma once
+#include "../external/Angel/inlcude/Angel/Angel.h"
+#include "global/GlobalConfig.h"
+#include <vector>
+
+namespace spider {
+
+    // Everything the simulation reads and writes for a spider. It holds no GL
+    // resources, so it can be created, copied and stepped without a context.
+    struct SpiderState {
+        vec3 position;
+        vec3 forward;
+        float yaw;   // in degrees
+        float scale;
+
+        bool walkingForward;
+        bool walkingBackward;
+        bool turningLeft;
+        bool turningRight;
+
+        float legAnimationCycle;
+        float abdomenShakeCycle;
+
+        bool jumpTriggered;
+        bool jumping;
+        float jumpTime;
+
+        // Per-leg joint pitch angles in degrees, leg-major
+        float jointAngles[LEG_COUNT][LEG_SEGMENT_COUNT];
+    };
+
+    // The pose alpha (0..1) of the way from previous to current, for drawing between
+    // two simulation ticks. Yaw and the gait phases take the short way round their
+    // wrap; flags come from current. A spider that moved further than
+    // INTERPOLATION_SNAP_DISTANCE is returned as current.
+    SpiderState interpolate(const SpiderState& previous, const SpiderState& current, float alpha);
+
+    // interpolate() per index. Spiders past the end of previous (just spawned) are copied as they are.
+    void interpolateStates(const std::vector<SpiderState>& previous, const std::vector<SpiderState>& current,
+                           float alpha, std::vector<SpiderState>& out);
+
+} // namespace spider
@@ -7,7 +7,7 @@ public:
     Axes(GLuint program);  // accept program ID from outside
     ~Axes();
 
-    void draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& MV, const mat4& P) const;
+    void draw(GLuint modelLoc, const mat4& M) const;
 
 private:
     GLuint _vao = 0;
@@ -0,0 +1,36 @@
+// Description: Header file for the camera uniform buffer shared by every shader program.
+#ifndef CAMERA_UNIFORMS_H
+#define CAMERA_UNIFORMS_H
+
+#include <GL/glew.h>
+#include "../external/Angel/inlcude/Angel/Angel.h"
+#include "utils/GLHandle.h"
+
+// Mirrors the std140 Camera block declared in the vertex shaders. The block is
+// row_major, so Angel matrices are copied in as they are.
+struct CameraBlock {
+    GLfloat view[16];
+    GLfloat projection[16];
+    GLfloat viewProjection[16];
+};
+
+// One uniform buffer holding the camera matrices, written once per frame and
+// read by every program through the same binding point
+class CameraUniforms {
+public:
+    static const GLuint BINDING = 0;
+
+    // Creates the buffer and binds it to BINDING; needs a current GL context
+    CameraUniforms();
+
+    // Points the program's Camera block at BINDING. Returns false if the
+    // program does not declare the block.
+    static bool attach(GLuint program);
+
+    void update(const mat4& view, const mat4& projection);
+
+private:
+    GLBuffer buffer_;
+};
+
+#endif // CAMERA_UNIFORMS_H
@@ -0,0 +1,21 @@
+// Description: Header file for the draw call counters used to compare render paths.
+#ifndef DRAW_STATS_H
+#define DRAW_STATS_H
+
+#include <cstddef>
+
+struct DrawStats {
+    size_t drawCalls;   // glDraw* calls issued
+    size_t instances;   // instances those calls drew (1 for a non-instanced draw)
+    size_t triangles;   // triangles across all instances
+    size_t visible;     // spiders and obstacles that passed frustum culling
+    size_t culled;      // spiders and obstacles skipped by frustum culling
+};
+
+// Counters are plain integers: only the thread that owns the GL context may touch them
+void recordDrawCall(size_t instances = 1, size_t trianglesPerInstance = 0);
+void recordCulling(size_t visible, size_t culled);
+DrawStats getDrawStats();
+void resetDrawStats();
+
+#endif // DRAW_STATS_H
@@ -0,0 +1,79 @@
+// Description: Header file for move-only owners of OpenGL object names.
+#ifndef GL_HANDLE_H
+#define GL_HANDLE_H
+
+#include <GL/glew.h>
+
+// Owns one GL object name and deletes it when destroyed. Copies are disabled,
+// so two owners can never delete the same name; moves hand the name over and
+// leave the source empty. Traits supply create() and destroy(name).
+template <typename Traits>
+class GLHandle {
+public:
+    GLHandle() : name_(0) {}
+    explicit GLHandle(GLuint name) : name_(name) {}
+    ~GLHandle() { reset(); }
+
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+
+    GLHandle(GLHandle&& other) noexcept : name_(other.release()) {}
+    GLHandle& operator=(GLHandle&& other) noexcept {
+        if (this != &other) {
+            reset(other.release());
+        }
+        return *this;
+    }
+
+    // Generates a new object; needs a current GL context
+    static GLHandle create() { return GLHandle(Traits::create()); }
+
+    GLuint get() const { return name_; }
+    explicit operator bool() const { return name_ != 0; }
+
+    // Gives up ownership without deleting
+    GLuint release() {
+        GLuint name = name_;
+        name_ = 0;
+        return name;
+    }
+
+    // Deletes the owned object, if any, and takes ownership of name
+    void reset(GLuint name = 0) {
+        if (name_ != 0) {
+            Traits::destroy(name_);
+        }
+        name_ = name;
+    }
+
+private:
+    GLuint name_;
+};
+
+struct GLVertexArrayTraits {
+    static GLuint create() { GLuint name = 0; glGenVertexArrays(1, &name); return name; }
+    static void destroy(GLuint name) { glDeleteVertexArrays(1, &name); }
+};
+
+struct GLBufferTraits {
+    static GLuint create() { GLuint name = 0; glGenBuffers(1, &name); return name; }
+    static void destroy(GLuint name) { glDeleteBuffers(1, &name); }
+};
+
+struct GLTextureTraits {
+    static GLuint create() { GLuint name = 0; glGenTextures(1, &name); return name; }
+    static void destroy(GLuint name) { glDeleteTextures(1, &name); }
+};
+
+// Programs come from InitShader, so they are usually adopted with GLProgram(name)
+struct GLProgramTraits {
+    static GLuint create() { return glCreateProgram(); }
+    static void destroy(GLuint name) { glDeleteProgram(name); }
+};
+
+typedef GLHandle<GLVertexArrayTraits> GLVertexArray;
+typedef GLHandle<GLBufferTraits> GLBuffer;
+typedef GLHandle<GLTextureTraits> GLTexture;
+typedef GLHandle<GLProgramTraits> GLProgram;
+
+#endif // GL_HANDLE_H
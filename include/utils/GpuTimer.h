@@ -0,0 +1,75 @@
+// Description: Header file for per-pass GPU timing with a ring of timestamp queries.
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+
+// The render passes of a frame, in submission order
+enum GpuPass {
+    GPU_PASS_OBSTACLES,
+    GPU_PASS_AI_SPIDERS,
+    GPU_PASS_PLAYER,
+    GPU_PASS_GROUND,
+    GPU_PASS_OVERLAY,
+    GPU_PASS_COUNT
+};
+
+// Milliseconds over the last GpuTimer::HISTORY measured frames
+struct GpuPassStats {
+    float average;
+    float p50;
+    float p95;
+    float p99;
+    size_t samples;
+};
+
+// Puts a GL_TIMESTAMP query before the first pass and after each one, so a
+// pass's GPU time is the difference of two neighbouring timestamps. Queries
+// are recycled over FRAMES_IN_FLIGHT frames: a frame's results are read when
+// its slot comes round again and only if the GPU has already written them, so
+// reading never waits. Frames that are still pending then are dropped.
+// Must be used from the thread that owns the GL context.
+class GpuTimer {
+public:
+    static const int FRAMES_IN_FLIGHT = 4;
+    static const int HISTORY = 120;
+
+    // Creates the queries; needs a current GL context. Without timer query
+    // support (or with a zero-bit counter) every call is a no-op.
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    bool isSupported() const;
+
+    // Collects the oldest frame in the ring if it is ready and opens a new one
+    void beginFrame();
+    // Marks the end of pass; passes must be marked once each, in enum order
+    void endPass(GpuPass pass);
+
+    GpuPassStats getStats(GpuPass pass) const;
+    // Frames whose results were not ready when their queries had to be reused
+    size_t getDroppedFrames() const;
+
+    static const char* getPassName(GpuPass pass);
+
+private:
+    static const int QUERIES_PER_FRAME = GPU_PASS_COUNT + 1;
+
+    void collect(int slot);
+
+    bool supported_;
+    GLuint queries_[FRAMES_IN_FLIGHT][QUERIES_PER_FRAME];
+    bool issued_[FRAMES_IN_FLIGHT];
+    int slot_;
+
+    float history_[GPU_PASS_COUNT][HISTORY];
+    size_t recorded_;   // frames collected so far; history index is recorded_ % HISTORY
+    size_t dropped_;
+};
+
+#endif // GPU_TIMER_H
@@ -0,0 +1,90 @@
+// Description: Header file for a small work-stealing job system and the per-frame task graph it runs.
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A set of tasks with "runs before" edges. Built once and run every frame.
+class TaskGraph {
+public:
+    typedef size_t TaskId;
+
+    TaskId add(const char* name, std::function<void()> work);
+    // `after` starts only once `before` has finished
+    void precede(TaskId before, TaskId after);
+
+    size_t size() const;
+    const char* getName(TaskId id) const;
+    void clear();
+
+private:
+    friend class JobSystem;
+
+    struct Task {
+        const char* name;
+        std::function<void()> work;
+        std::vector<TaskId> successors;
+        int dependencyCount = 0;
+        std::atomic<int> remaining;
+    };
+
+    std::vector<std::unique_ptr<Task>> tasks_;
+};
+
+// Fixed pool of worker threads, each with its own deque. Owners push and pop
+// at the back, idle workers steal from the front of other deques. The thread
+// that calls parallelFor/run helps with the work while it waits.
+class JobSystem {
+public:
+    explicit JobSystem(unsigned workerCount = defaultWorkerCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Hardware threads minus the calling thread, at least one
+    static unsigned defaultWorkerCount();
+    unsigned getWorkerCount() const;
+
+    // Calls body(begin, end) over [0, count) in chunks of at most grainSize and waits for all of them
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+    // Runs every task in dependency order and waits until the whole graph has finished
+    void run(TaskGraph& graph);
+
+private:
+    struct Job {
+        std::function<void()> work;
+        std::atomic<int>* pending;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void submit(Job job);
+    bool tryRunOne();
+    void wait(std::atomic<int>& pending);
+    void workerLoop(unsigned queueIndex);
+    void scheduleTask(TaskGraph& graph, TaskGraph::TaskId id, std::atomic<int>& pending);
+
+    // Queue 0 belongs to outside threads (the main loop), 1..N to the workers
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<bool> stopping_;
+    std::atomic<int> queued_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+};
+
+#endif // JOB_SYSTEM_H
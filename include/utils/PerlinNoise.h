@@ -1,26 +1,70 @@
 // Reference: https://en.wikipedia.org/wiki/Perlin_noise
 // Reference: *https://garagefarm.net/blog/perlin-noise-implementation-procedural-generation-and-simplex-noise
+// Reference: https://weber.itn.liu.se/~stegu/simplexnoise/simplexnoise.pdf (simplex variant)
 
 
 #ifndef PERLIN_NOISE_H
 #define PERLIN_NOISE_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <random>
 
+// Improved Perlin noise, or simplex noise on the same gradient set
+enum class NoiseKind {
+    Perlin,
+    Simplex
+};
+
+// A noise value in [0, 1] and its analytic gradient with respect to the input point
+struct NoiseSample {
+    float value;
+    float dx, dy, dz;
+};
+
+// Points and results of one batched evaluation, in structure-of-arrays layout
+struct NoiseBatch {
+    size_t count = 0;
+    const float* x = nullptr;   // [count]
+    const float* y = nullptr;
+    const float* z = nullptr;
+
+    float* value = nullptr;     // [count]
+    // Optional [count] gradient outputs; set all three or none
+    float* gradX = nullptr;
+    float* gradY = nullptr;
+    float* gradZ = nullptr;
+};
+
 class PerlinNoise {
 public:
+    // Seed 0 is the permutation every body mesh has been built with
     PerlinNoise();
-    float noise(float x, float y, float z);
+    explicit PerlinNoise(unsigned seed);
+
+    float noise(float x, float y, float z) const;
+
+    // One point with its gradient. Perlin values match noise() to float rounding.
+    NoiseSample sample(NoiseKind kind, float x, float y, float z) const;
+
+    // Evaluates every point of the batch simd::WIDTH at a time; results match
+    // sample() to float rounding
+    void evaluate(NoiseKind kind, const NoiseBatch& batch) const;
+
+    // Lanes per batched evaluation and the instruction set they were built for
+    static int batchWidth();
+    static const char* batchInstructionSet();
 
 private:
-    std::vector<int> p;
+    // The 256-entry permutation twice over, so corner lookups never wrap
+    int32_t p[512];
 
-    void generatePermutation();
-    float fade(float t);
-    float grad(int hash, float x, float y, float z);
-    float lerp(float t, float a, float b);
+    void generatePermutation(unsigned seed);
+    float fade(float t) const;
+    float grad(int hash, float x, float y, float z) const;
+    float lerp(float t, float a, float b) const;
 };
 
-#endif // PERLIN_NOISE_H
\ No newline at end of file
+#endif // PERLIN_NOISE_H
@@ -0,0 +1,75 @@
+// Description: Header file for the scoped CPU trace profiler and its Chrome trace export.
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Build with SPIDER_PROFILING=1 (the SPIDER_PROFILING CMake option) to record.
+// Otherwise every PROFILE_* macro expands to nothing and no profiler code is
+// compiled, so instrumented code costs nothing in a normal build.
+//
+//   PROFILE_SCOPE("collisions");     // times the rest of the enclosing block
+//   PROFILE_THREAD_NAME("render");   // label for this thread in the trace viewer
+//   PROFILE_DUMP("trace.json");      // writes what the rings hold right now
+//
+// Names must outlive the trace, so pass string literals.
+
+#ifndef SPIDER_PROFILING
+#define SPIDER_PROFILING 0
+#endif
+
+// Where main and the headless runner write the trace on exit (and main on P)
+#define PROFILE_TRACE_PATH "spider_trace.json"
+
+#if SPIDER_PROFILING
+
+#include <cstddef>
+#include <cstdint>
+
+namespace profiler {
+
+    // Completed scopes kept per thread; older ones are overwritten
+    const size_t RING_CAPACITY = 1 << 16;
+
+    // Nanoseconds on a steady clock, counted from the first call in the process
+    uint64_t nowNs();
+
+    // Appends a finished scope to the calling thread's ring. Lock-free after the
+    // thread's first event, which registers its ring.
+    void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    void setThreadName(const char* name);
+
+    // Writes every ring as Chrome trace_event JSON (load it in chrome://tracing or
+    // Perfetto). Threads may keep recording meanwhile; events they overwrite during
+    // the copy are left out. Returns false if the file could not be written.
+    bool writeChromeTrace(const char* path);
+
+    class Scope {
+    public:
+        explicit Scope(const char* name) : name_(name), startNs_(nowNs()) {}
+        ~Scope() { record(name_, startNs_, nowNs()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_;
+        uint64_t startNs_;
+    };
+
+} // namespace profiler
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ::profiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) ::profiler::setThreadName(name)
+#define PROFILE_DUMP(path) ::profiler::writeChromeTrace(path)
+
+#else
+
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_THREAD_NAME(name) do {} while (0)
+#define PROFILE_DUMP(path) do {} while (0)
+
+#endif // SPIDER_PROFILING
+
+#endif // PROFILER_H
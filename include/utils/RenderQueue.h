@@ -0,0 +1,68 @@
+// Description: Header file for the render queue that sorts draw packets to minimise GL state changes.
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../external/Angel/inlcude/Angel/Angel.h"
+
+// Everything needed to issue one non-instanced draw. The camera comes from
+// the Camera uniform block, so only per-object uniforms are carried here.
+struct DrawPacket {
+    GLuint program = 0;
+    GLuint vertexArray = 0;
+    GLsizei count = 0;
+    bool indexed = true;        // glDrawElements on GL_UNSIGNED_INT, otherwise glDrawArrays
+    GLint modelLoc = -1;        // -1 when the program takes no model matrix
+    mat4 model;
+    GLuint texture = 0;         // GL_TEXTURE_2D on unit 0, 0 for none
+    GLint colorLoc = -1;        // -1 when the program takes no colour
+    vec4 color;
+};
+
+struct RenderQueueStats {
+    size_t packets;             // draws submitted since begin
+    size_t programChanges;      // glUseProgram calls
+    size_t vertexArrayChanges;  // glBindVertexArray calls
+    size_t textureChanges;      // glBindTexture calls
+};
+
+// Collects a frame's draws, sorts them by a 64-bit key and submits them with
+// each program, VAO and texture bound once per run of equal state.
+// Key layout, most significant first:
+//   program (12 bits) | vertex array (20 bits) | view depth (32 bits)
+// so packets group by program, then mesh, then draw front to back. The ids
+// only decide the order; submission still compares the full GL names.
+// Must be used from the thread that owns the GL context.
+class RenderQueue {
+public:
+    RenderQueue();
+
+    // Starts a frame and clears the counters; depths are measured along the view matrix's -Z axis
+    void begin(const mat4& view);
+    void push(const DrawPacket& packet);
+    // Sorts, submits and clears the packets pushed since begin or the previous
+    // flush. Several flushes per frame split it into passes that are sorted
+    // separately, e.g. to time each one.
+    void flush();
+
+    // Counters summed over every flush since begin
+    const RenderQueueStats& getStats() const;
+
+    static uint64_t makeKey(GLuint program, GLuint vertexArray, float depth);
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t packet;
+    };
+
+    mat4 view_;
+    std::vector<DrawPacket> packets_;
+    std::vector<SortEntry> order_;
+    RenderQueueStats stats_;
+};
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,255 @@
+// SimdMath.h
+// Thin SIMD wrapper plus vectorized sin/cos/atan2, used by the batched solvers and noise.
+// Picks AVX2 (8 lanes), then SSE2 (4 lanes), and otherwise falls back to a
+// portable 4-lane array so the same code builds on every platform.
+// The transcendental approximations follow the Cephes single-precision routines
+// (max error around 1e-7 on the ranges used here).
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SPIDER_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPIDER_SIMD_SSE2 1
+#else
+#define SPIDER_SIMD_SCALAR 1
+#endif
+
+namespace simd {
+
+#if defined(SPIDER_SIMD_AVX2)
+
+    const int WIDTH = 8;
+    inline const char* instructionSet() { return "AVX2"; }
+
+    struct VFloat { __m256 v; };
+    struct VInt   { __m256i v; };
+
+    inline VFloat set1(float x)               { return { _mm256_set1_ps(x) }; }
+    inline VFloat load(const float* p)        { return { _mm256_loadu_ps(p) }; }
+    inline void   store(float* p, VFloat a)   { _mm256_storeu_ps(p, a.v); }
+    inline VFloat operator+(VFloat a, VFloat b) { return { _mm256_add_ps(a.v, b.v) }; }
+    inline VFloat operator-(VFloat a, VFloat b) { return { _mm256_sub_ps(a.v, b.v) }; }
+    inline VFloat operator*(VFloat a, VFloat b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    inline VFloat operator/(VFloat a, VFloat b) { return { _mm256_div_ps(a.v, b.v) }; }
+    inline VFloat operator&(VFloat a, VFloat b) { return { _mm256_and_ps(a.v, b.v) }; }
+    inline VFloat operator|(VFloat a, VFloat b) { return { _mm256_or_ps(a.v, b.v) }; }
+    inline VFloat operator^(VFloat a, VFloat b) { return { _mm256_xor_ps(a.v, b.v) }; }
+    inline VFloat andNot(VFloat mask, VFloat a) { return { _mm256_andnot_ps(mask.v, a.v) }; }
+    inline VFloat min(VFloat a, VFloat b)     { return { _mm256_min_ps(a.v, b.v) }; }
+    inline VFloat max(VFloat a, VFloat b)     { return { _mm256_max_ps(a.v, b.v) }; }
+    inline VFloat sqrt(VFloat a)              { return { _mm256_sqrt_ps(a.v) }; }
+    inline VFloat less(VFloat a, VFloat b)    { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+    inline VFloat greater(VFloat a, VFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+    inline VFloat equal(VFloat a, VFloat b)   { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+    inline VFloat select(VFloat mask, VFloat a, VFloat b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+    inline int    moveMask(VFloat mask)       { return _mm256_movemask_ps(mask.v); }
+    inline VFloat floor(VFloat a)             { return { _mm256_floor_ps(a.v) }; }
+
+    inline VInt   truncate(VFloat a)          { return { _mm256_cvttps_epi32(a.v) }; }
+    inline VFloat toFloat(VInt a)             { return { _mm256_cvtepi32_ps(a.v) }; }
+    inline VInt   set1i(int32_t x)            { return { _mm256_set1_epi32(x) }; }
+    inline VInt   operator+(VInt a, VInt b)   { return { _mm256_add_epi32(a.v, b.v) }; }
+    inline VInt   operator-(VInt a, VInt b)   { return { _mm256_sub_epi32(a.v, b.v) }; }
+    inline VInt   operator&(VInt a, VInt b)   { return { _mm256_and_si256(a.v, b.v) }; }
+    inline VInt   andNot(VInt mask, VInt a)   { return { _mm256_andnot_si256(mask.v, a.v) }; }
+    inline VInt   equal(VInt a, VInt b)       { return { _mm256_cmpeq_epi32(a.v, b.v) }; }
+    template <int N> inline VInt shiftLeft(VInt a) { return { _mm256_slli_epi32(a.v, N) }; }
+    inline VFloat asFloat(VInt a)             { return { _mm256_castsi256_ps(a.v) }; }
+    inline VInt   asInt(VFloat a)             { return { _mm256_castps_si256(a.v) }; }
+    inline VInt   gather(const int32_t* table, VInt index) { return { _mm256_i32gather_epi32(table, index.v, 4) }; }
+
+#elif defined(SPIDER_SIMD_SSE2)
+
+    const int WIDTH = 4;
+    inline const char* instructionSet() { return "SSE2"; }
+
+    struct VFloat { __m128 v; };
+    struct VInt   { __m128i v; };
+
+    inline VFloat set1(float x)               { return { _mm_set1_ps(x) }; }
+    inline VFloat load(const float* p)        { return { _mm_loadu_ps(p) }; }
+    inline void   store(float* p, VFloat a)   { _mm_storeu_ps(p, a.v); }
+    inline VFloat operator+(VFloat a, VFloat b) { return { _mm_add_ps(a.v, b.v) }; }
+    inline VFloat operator-(VFloat a, VFloat b) { return { _mm_sub_ps(a.v, b.v) }; }
+    inline VFloat operator*(VFloat a, VFloat b) { return { _mm_mul_ps(a.v, b.v) }; }
+    inline VFloat operator/(VFloat a, VFloat b) { return { _mm_div_ps(a.v, b.v) }; }
+    inline VFloat operator&(VFloat a, VFloat b) { return { _mm_and_ps(a.v, b.v) }; }
+    inline VFloat operator|(VFloat a, VFloat b) { return { _mm_or_ps(a.v, b.v) }; }
+    inline VFloat operator^(VFloat a, VFloat b) { return { _mm_xor_ps(a.v, b.v) }; }
+    inline VFloat andNot(VFloat mask, VFloat a) { return { _mm_andnot_ps(mask.v, a.v) }; }
+    inline VFloat min(VFloat a, VFloat b)     { return { _mm_min_ps(a.v, b.v) }; }
+    inline VFloat max(VFloat a, VFloat b)     { return { _mm_max_ps(a.v, b.v) }; }
+    inline VFloat sqrt(VFloat a)              { return { _mm_sqrt_ps(a.v) }; }
+    inline VFloat less(VFloat a, VFloat b)    { return { _mm_cmplt_ps(a.v, b.v) }; }
+    inline VFloat greater(VFloat a, VFloat b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+    inline VFloat equal(VFloat a, VFloat b)   { return { _mm_cmpeq_ps(a.v, b.v) }; }
+    inline VFloat select(VFloat mask, VFloat a, VFloat b) {
+        return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+    }
+    inline int    moveMask(VFloat mask)       { return _mm_movemask_ps(mask.v); }
+
+    inline VInt   truncate(VFloat a)          { return { _mm_cvttps_epi32(a.v) }; }
+    inline VFloat toFloat(VInt a)             { return { _mm_cvtepi32_ps(a.v) }; }
+    inline VInt   set1i(int32_t x)            { return { _mm_set1_epi32(x) }; }
+    inline VInt   operator+(VInt a, VInt b)   { return { _mm_add_epi32(a.v, b.v) }; }
+    inline VInt   operator-(VInt a, VInt b)   { return { _mm_sub_epi32(a.v, b.v) }; }
+    inline VInt   operator&(VInt a, VInt b)   { return { _mm_and_si128(a.v, b.v) }; }
+    inline VInt   andNot(VInt mask, VInt a)   { return { _mm_andnot_si128(mask.v, a.v) }; }
+    inline VInt   equal(VInt a, VInt b)       { return { _mm_cmpeq_epi32(a.v, b.v) }; }
+    template <int N> inline VInt shiftLeft(VInt a) { return { _mm_slli_epi32(a.v, N) }; }
+    inline VFloat asFloat(VInt a)             { return { _mm_castsi128_ps(a.v) }; }
+    inline VInt   asInt(VFloat a)             { return { _mm_castps_si128(a.v) }; }
+    // No gather before AVX2: look the four lanes up one by one
+    inline VInt   gather(const int32_t* table, VInt index) {
+        int32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), index.v);
+        return { _mm_setr_epi32(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]) };
+    }
+
+    // SSE2 has no floor; truncate and step down where truncation rounded up
+    inline VFloat floor(VFloat a) {
+        VFloat t = toFloat(truncate(a));
+        return t - (greater(t, a) & set1(1.0f));
+    }
+
+#else
+
+    const int WIDTH = 4;
+    inline const char* instructionSet() { return "scalar"; }
+
+    struct VFloat { float v[WIDTH]; };
+    struct VInt   { int32_t v[WIDTH]; };
+
+#define SPIDER_SIMD_LANES(result, expr) for (int l = 0; l < WIDTH; ++l) { result.v[l] = (expr); }
+
+    inline uint32_t bitsOf(float x)   { uint32_t u; std::memcpy(&u, &x, sizeof u); return u; }
+    inline float    floatOf(uint32_t u) { float x; std::memcpy(&x, &u, sizeof x); return x; }
+    inline float    maskOf(bool b)    { return floatOf(b ? 0xFFFFFFFFu : 0u); }
+
+    inline VFloat set1(float x)               { VFloat r; SPIDER_SIMD_LANES(r, x); return r; }
+    inline VFloat load(const float* p)        { VFloat r; SPIDER_SIMD_LANES(r, p[l]); return r; }
+    inline void   store(float* p, VFloat a)   { for (int l = 0; l < WIDTH; ++l) p[l] = a.v[l]; }
+    inline VFloat operator+(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, a.v[l] + b.v[l]); return r; }
+    inline VFloat operator-(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, a.v[l] - b.v[l]); return r; }
+    inline VFloat operator*(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, a.v[l] * b.v[l]); return r; }
+    inline VFloat operator/(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, a.v[l] / b.v[l]); return r; }
+    inline VFloat operator&(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, floatOf(bitsOf(a.v[l]) & bitsOf(b.v[l]))); return r; }
+    inline VFloat operator|(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, floatOf(bitsOf(a.v[l]) | bitsOf(b.v[l]))); return r; }
+    inline VFloat operator^(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, floatOf(bitsOf(a.v[l]) ^ bitsOf(b.v[l]))); return r; }
+    inline VFloat andNot(VFloat mask, VFloat a) { VFloat r; SPIDER_SIMD_LANES(r, floatOf(~bitsOf(mask.v[l]) & bitsOf(a.v[l]))); return r; }
+    inline VFloat min(VFloat a, VFloat b)     { VFloat r; SPIDER_SIMD_LANES(r, a.v[l] < b.v[l] ? a.v[l] : b.v[l]); return r; }
+    inline VFloat max(VFloat a, VFloat b)     { VFloat r; SPIDER_SIMD_LANES(r, a.v[l] > b.v[l] ? a.v[l] : b.v[l]); return r; }
+    inline VFloat sqrt(VFloat a)              { VFloat r; SPIDER_SIMD_LANES(r, std::sqrt(a.v[l])); return r; }
+    inline VFloat less(VFloat a, VFloat b)    { VFloat r; SPIDER_SIMD_LANES(r, maskOf(a.v[l] < b.v[l])); return r; }
+    inline VFloat greater(VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, maskOf(a.v[l] > b.v[l])); return r; }
+    inline VFloat equal(VFloat a, VFloat b)   { VFloat r; SPIDER_SIMD_LANES(r, maskOf(a.v[l] == b.v[l])); return r; }
+    inline VFloat select(VFloat mask, VFloat a, VFloat b) { VFloat r; SPIDER_SIMD_LANES(r, bitsOf(mask.v[l]) ? a.v[l] : b.v[l]); return r; }
+    inline int    moveMask(VFloat mask) {
+        int bits = 0;
+        for (int l = 0; l < WIDTH; ++l) bits |= (bitsOf(mask.v[l]) >> 31) << l;
+        return bits;
+    }
+    inline VFloat floor(VFloat a)             { VFloat r; SPIDER_SIMD_LANES(r, std::floor(a.v[l])); return r; }
+
+    inline VInt   truncate(VFloat a)          { VInt r; SPIDER_SIMD_LANES(r, static_cast<int32_t>(a.v[l])); return r; }
+    inline VFloat toFloat(VInt a)             { VFloat r; SPIDER_SIMD_LANES(r, static_cast<float>(a.v[l])); return r; }
+    inline VInt   set1i(int32_t x)            { VInt r; SPIDER_SIMD_LANES(r, x); return r; }
+    inline VInt   operator+(VInt a, VInt b)   { VInt r; SPIDER_SIMD_LANES(r, a.v[l] + b.v[l]); return r; }
+    inline VInt   operator-(VInt a, VInt b)   { VInt r; SPIDER_SIMD_LANES(r, a.v[l] - b.v[l]); return r; }
+    inline VInt   operator&(VInt a, VInt b)   { VInt r; SPIDER_SIMD_LANES(r, a.v[l] & b.v[l]); return r; }
+    inline VInt   andNot(VInt mask, VInt a)   { VInt r; SPIDER_SIMD_LANES(r, ~mask.v[l] & a.v[l]); return r; }
+    inline VInt   equal(VInt a, VInt b)       { VInt r; SPIDER_SIMD_LANES(r, a.v[l] == b.v[l] ? -1 : 0); return r; }
+    template <int N> inline VInt shiftLeft(VInt a) {
+        VInt r; SPIDER_SIMD_LANES(r, static_cast<int32_t>(static_cast<uint32_t>(a.v[l]) << N)); return r;
+    }
+    inline VFloat asFloat(VInt a)             { VFloat r; SPIDER_SIMD_LANES(r, floatOf(static_cast<uint32_t>(a.v[l]))); return r; }
+    inline VInt   asInt(VFloat a)             { VInt r; SPIDER_SIMD_LANES(r, static_cast<int32_t>(bitsOf(a.v[l]))); return r; }
+    inline VInt   gather(const int32_t* table, VInt index) { VInt r; SPIDER_SIMD_LANES(r, table[index.v[l]]); return r; }
+
+#undef SPIDER_SIMD_LANES
+
+#endif
+
+    // ---- helpers shared by every backend ----
+
+    const int ALL_LANES = (1 << WIDTH) - 1;
+
+    inline VFloat signMask()          { return asFloat(set1i(static_cast<int32_t>(0x80000000u))); }
+    inline VFloat abs(VFloat a)       { return andNot(signMask(), a); }
+    inline VFloat trueMask()          { return asFloat(set1i(-1)); }
+    inline VFloat falseMask()         { return set1(0.0f); }
+    inline bool   allSet(VFloat mask) { return moveMask(mask) == ALL_LANES; }
+    inline bool   anySet(VFloat mask) { return moveMask(mask) != 0; }
+
+    // sin and cos of `x` radians at once
+    inline void sincos(VFloat x, VFloat& sinOut, VFloat& cosOut) {
+        const VFloat sign = signMask();
+        VFloat signSin = x & sign;
+        x = abs(x);
+
+        // Octant index, rounded up to even
+        VFloat y = x * set1(1.27323954473516f); // 4 / pi
+        VInt j = truncate(y);
+        j = (j + set1i(1)) & set1i(~1);
+        y = toFloat(j);
+
+        VFloat swapSignSin = asFloat(shiftLeft<29>(j & set1i(4)));
+        VFloat polyMask = asFloat(equal(j & set1i(2), set1i(0)));
+        VFloat signCos = asFloat(shiftLeft<29>(andNot(j - set1i(2), set1i(4))));
+        signSin = signSin ^ swapSignSin;
+
+        // Extended precision modular arithmetic
+        x = ((x - y * set1(0.78515625f)) - y * set1(2.4187564849853515625e-4f)) - y * set1(3.77489497744594108e-8f);
+        VFloat z = x * x;
+
+        VFloat c = set1(2.443315711809948e-5f);
+        c = c * z + set1(-1.388731625493765e-3f);
+        c = c * z + set1(4.166664568298827e-2f);
+        c = c * z * z - z * set1(0.5f) + set1(1.0f);
+
+        VFloat s = set1(-1.9515295891e-4f);
+        s = s * z + set1(8.3321608736e-3f);
+        s = s * z + set1(-1.6666654611e-1f);
+        s = s * z * x + x;
+
+        sinOut = select(polyMask, s, c) ^ signSin;
+        cosOut = select(polyMask, c, s) ^ signCos;
+    }
+
+    // atan of a non-negative argument
+    inline VFloat atanPositive(VFloat x) {
+        const VFloat tan3PiOver8 = set1(2.414213562373095f);
+        const VFloat tanPiOver8 = set1(0.4142135623730950f);
+        VFloat big = greater(x, tan3PiOver8);
+        VFloat mid = andNot(big, greater(x, tanPiOver8));
+
+        VFloat y0 = select(big, set1(1.5707963267948966f), select(mid, set1(0.7853981633974483f), set1(0.0f)));
+        VFloat reduced = select(big, set1(-1.0f) / x,
+                         select(mid, (x - set1(1.0f)) / (x + set1(1.0f)), x));
+
+        VFloat z = reduced * reduced;
+        VFloat p = set1(8.05374449538e-2f);
+        p = p * z - set1(1.38776856032e-1f);
+        p = p * z + set1(1.99777106478e-1f);
+        p = p * z - set1(3.33329491539e-1f);
+        return y0 + p * z * reduced + reduced;
+    }
+
+    // atan2(y, x) in radians, (-pi, pi]; returns 0 for (0, 0) like std::atan2
+    inline VFloat atan2(VFloat y, VFloat x) {
+        VFloat ax = abs(x);
+        VFloat ay = abs(y);
+        VFloat bothZero = equal(ax + ay, set1(0.0f));
+        VFloat a = atanPositive(ay / select(bothZero, set1(1.0f), ax));
+        a = select(less(x, set1(0.0f)), set1(3.14159265358979f) - a, a);
+        a = a ^ (y & signMask());
+        return select(bothZero, set1(0.0f), a);
+    }
+
+} // namespace simd
@@ -0,0 +1,52 @@
+// Description: Header file for a lock-free single-producer single-consumer triple buffer.
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Three slots of T: the writer fills its back slot while the reader holds its
+// front slot, and the third sits in between holding the newest published value.
+// publish() and acquire() swap a slot with the middle one through a single
+// atomic exchange, so neither side ever waits on the other. Exactly one thread
+// may write and exactly one may read.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back_(0), middle_(1), front_(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side: the slot to fill. Its old contents are whatever was
+    // written there two publishes ago, so containers keep their capacity.
+    T& back() { return slots_[back_]; }
+
+    // Writer side: hands the back slot over as the newest value
+    void publish() {
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side: takes the newest value if one was published since the last
+    // call. Returns false (and keeps the old front) otherwise.
+    bool acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Reader side: the value taken by the last successful acquire()
+    const T& front() const { return slots_[front_]; }
+
+private:
+    static const unsigned INDEX_MASK = 3u;
+    static const unsigned FRESH = 4u;
+
+    T slots_[3];
+    unsigned back_;
+    std::atomic<unsigned> middle_;
+    unsigned front_;
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,22 @@
+// Description: Header file for view-frustum planes and sphere visibility tests.
+#ifndef VIEW_FRUSTUM_H
+#define VIEW_FRUSTUM_H
+
+#include "../external/Angel/inlcude/Angel/Angel.h"
+
+// The six clip planes of a view-projection matrix, normalised so that
+// dot(plane.xyz, p) + plane.w is the signed distance of p from the plane
+// (positive inside).
+class ViewFrustum {
+public:
+    // Gribb-Hartmann extraction from the rows of projection * view
+    explicit ViewFrustum(const mat4& viewProjection);
+
+    // True unless the sphere lies completely outside one of the planes
+    bool intersectsSphere(const vec3& center, float radius) const;
+
+private:
+    vec4 planes_[6];
+};
+
+#endif // VIEW_FRUSTUM_H
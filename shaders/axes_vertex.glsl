@@ -3,12 +3,16 @@
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vColor;
 
-uniform mat4 model_view;
-uniform mat4 projection;
+layout(std140, row_major) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
+uniform mat4 model;
 
 out vec3 fColor;
 
 void main() {
-    gl_Position = projection * model_view * vec4(vPosition, 1.0);
+    gl_Position = viewProjection * model * vec4(vPosition, 1.0);
     fColor = vColor;
 }
@@ -5,10 +5,14 @@ layout(location = 2) in vec2 vTexCoord;
 
 out vec2 texCoord;
 
-uniform mat4 model_view;
-uniform mat4 projection;
+layout(std140, row_major) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
 
 void main() {
     texCoord = vTexCoord;
-    gl_Position = projection * model_view * vec4(vPosition, 1.0);
+    // The ground is authored in world space, so it needs no model matrix
+    gl_Position = viewProjection * vec4(vPosition, 1.0);
 }
\ No newline at end of file
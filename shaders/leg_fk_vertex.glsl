@@ -0,0 +1,104 @@
+#version 330 core
+
+layout(location = 0) in vec3 vPosition;
+layout(location = 1) in vec3 vNormal;
+
+// Per spider, texelsPerSpider RGBA32F texels:
+//   0: position.xyz, yaw (degrees)
+//   1: scale, leg swing (degrees), unused, unused
+//   2..: joint angles (degrees), leg-major, four per texel
+uniform samplerBuffer spiderLegData;
+uniform int texelsPerSpider;
+uniform int segmentCount;
+uniform float segmentLength;
+
+// One draw covers the spiders [firstSpider, ...) that share a level of detail;
+// each drawn segment spans jointStride joints (1 draws every segment)
+uniform int firstSpider;
+uniform int jointStride;
+
+// Fixed per leg: where it mounts, which way it swings, whether it is mirrored, how thick it is
+uniform vec3 legAttachments[8];
+uniform float legSwingSign[8];
+uniform float legMirrorX[8];
+uniform float legThickness[8];
+
+layout(std140, row_major) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
+
+out vec3 fNormal;
+out vec3 fWorldPos;
+
+mat4 translate(vec3 t) {
+    mat4 m = mat4(1.0);
+    m[3] = vec4(t, 1.0);
+    return m;
+}
+
+mat4 rotateY(float degrees) {
+    float r = radians(degrees);
+    float c = cos(r), s = sin(r);
+    return mat4(vec4(c, 0.0, -s, 0.0), vec4(0.0, 1.0, 0.0, 0.0), vec4(s, 0.0, c, 0.0), vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+mat4 rotateZ(float degrees) {
+    float r = radians(degrees);
+    float c = cos(r), s = sin(r);
+    return mat4(vec4(c, s, 0.0, 0.0), vec4(-s, c, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+mat4 scale(vec3 s) {
+    return mat4(vec4(s.x, 0.0, 0.0, 0.0), vec4(0.0, s.y, 0.0, 0.0), vec4(0.0, 0.0, s.z, 0.0), vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+float jointAngle(int base, int index) {
+    vec4 texel = texelFetch(spiderLegData, base + 2 + index / 4);
+    return texel[index % 4];
+}
+
+void main() {
+    int drawnSegments = (segmentCount + jointStride - 1) / jointStride;
+    int segmentsPerSpider = 8 * drawnSegments;
+    int spider = firstSpider + gl_InstanceID / segmentsPerSpider;
+    int leg = (gl_InstanceID % segmentsPerSpider) / drawnSegments;
+    int segment = gl_InstanceID % drawnSegments;
+    int base = spider * texelsPerSpider;
+
+    vec4 body = texelFetch(spiderLegData, base);
+    vec4 extra = texelFetch(spiderLegData, base + 1);
+
+    // Same root as SpiderRenderer::computePartTransforms
+    mat4 root = translate(body.xyz) * rotateY(body.w) * scale(vec3(extra.x))
+              * translate(legAttachments[leg]) * rotateY(legSwingSign[leg] * extra.y)
+              * scale(vec3(legMirrorX[leg], 1.0, 1.0));
+
+    // Every joint turns about the leg's local Z, so the chain stays in its XY plane:
+    // accumulate the heading and walk the joint position along it, then span the
+    // drawn segment from its first joint to its last
+    float heading = 0.0;
+    vec2 joint = vec2(0.0);
+    int first = leg * segmentCount;
+    int startJoint = segment * jointStride;
+    int endJoint = min(startJoint + jointStride, segmentCount);
+    vec2 start = vec2(0.0);
+    for (int i = 0; i < endJoint; ++i) {
+        if (i == startJoint) {
+            start = joint;
+        }
+        heading += jointAngle(base, first + i);
+        joint += segmentLength * vec2(cos(radians(heading)), sin(radians(heading)));
+    }
+    vec2 span = joint - start;
+
+    float thickness = legThickness[leg];
+    mat4 model = root * translate(vec3(start, 0.0)) * rotateZ(degrees(atan(span.y, span.x)))
+               * scale(vec3(length(span), thickness, thickness));
+    mat4 model_view = view * model;
+
+    gl_Position = viewProjection * model * vec4(vPosition, 1.0);
+    fWorldPos = vPosition;
+    fNormal = mat3(model_view) * vNormal;
+}
@@ -2,9 +2,13 @@
 
 layout(location = 0) in vec3 vPosition;
 
-uniform mat4 model_view;
-uniform mat4 projection;
+layout(std140, row_major) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
+uniform mat4 model;
 
 void main() {
-    gl_Position = projection * model_view * vec4(vPosition, 1.0);
+    gl_Position = viewProjection * model * vec4(vPosition, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#version 330 core
+
+layout(location = 0) in vec3 vPosition;
+layout(location = 1) in vec3 vNormal;
+
+// Per-instance model matrix, one row per attribute (Angel matrices are row-major)
+layout(location = 2) in vec4 instanceRow0;
+layout(location = 3) in vec4 instanceRow1;
+layout(location = 4) in vec4 instanceRow2;
+layout(location = 5) in vec4 instanceRow3;
+
+layout(std140, row_major) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
+
+out vec3 fNormal;
+out vec3 fWorldPos;
+
+void main() {
+    mat4 model = transpose(mat4(instanceRow0, instanceRow1, instanceRow2, instanceRow3));
+    mat4 model_view = view * model;
+    gl_Position = viewProjection * model * vec4(vPosition, 1.0);
+    fWorldPos = vPosition;
+    fNormal = mat3(model_view) * vNormal;
+}
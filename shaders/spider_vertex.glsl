@@ -4,14 +4,20 @@
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec3 vNormal;
 
-uniform mat4 model_view;
-uniform mat4 projection;
+// Camera matrices shared by every program, written once per frame (see CameraUniforms)
+layout(std140, row_major) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
+uniform mat4 model;
 
 out vec3 fNormal;
 out vec3 fWorldPos;
 
 void main() {
-    gl_Position = projection * model_view * vec4(vPosition, 1.0);
+    mat4 model_view = view * model;
+    gl_Position = viewProjection * model * vec4(vPosition, 1.0);
     fWorldPos = vPosition;
     fNormal = mat3(model_view) * vNormal;
 }
\ No newline at end of file
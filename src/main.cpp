@@ -1,3 +1,7 @@
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <GL/glew.h>
@@ -7,59 +11,178 @@
 #include "global/GlobalConfig.h"
 #include "utils/Axes.h"
 #include "spider/Spider.h"
+#include "spider/SpiderRenderer.h"
 #include "spider/Leg.h"
 #include "spider/Abdomen.h"
 #include <vector>
 #include <iomanip>
+#include <cstring>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <memory>
+#include <sstream>
+#include <thread>
 
 #include "spider/LegSegment.h"
+#include "spider/MeshRegistry.h"
 #include "obstacle/Obstacle.h"
+#include "sim/World.h"
+#include "sim/Headless.h"
+#include "sim/FramePipeline.h"
+#include "sim/FrameSnapshot.h"
+#include "sim/FixedTimestep.h"
+#include "sim/InputLog.h"
+#include "utils/JobSystem.h"
+#include "utils/GLHandle.h"
+#include "utils/DrawStats.h"
+#include "utils/CameraUniforms.h"
+#include "utils/RenderQueue.h"
+#include "utils/ViewFrustum.h"
+#include "utils/TripleBuffer.h"
+#include "utils/Profiler.h"
+#include "utils/GpuTimer.h"
 
 using namespace Angel;
 
 
 // projection + model_view matrices
-GLuint programID, projLoc, mvLoc;
+GLuint programID;
 
 
 float spiderX = 0.0f;
-int score = 0;
 float speed = 0.01f;
 
 Camera camera;
 
-std::vector<Obstacle> obstacles;
-std::vector<spider::Spider> aiSpiders;
-
-
+World world;
 
+// Tears the window down when main returns, after every GL owner declared later in main
+struct GLFWSession {
+    GLFWwindow* window;
+    ~GLFWSession() {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+};
+
+// Numeric command line values: the whole argument must parse, and in range
+bool parseCount(const char* text, int& value) {
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed < 0 || parsed > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
 
-void setupObstacles(GLuint shaderProgram);
+bool parseRate(const char* text, float& value) {
+    char* end = nullptr;
+    float parsed = std::strtof(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(parsed) || parsed <= 0.0f) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
 
-void initAISpiders(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader) {
-    // Önceki AI örümcekleri temizle
-    aiSpiders.clear();
+bool parseSeed(const char* text, uint32_t& value) {
+    // strtoul would wrap "-1" around to the largest value instead of failing
+    if (std::strchr(text, '-') != nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    unsigned long parsed = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || parsed > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
 
-    // Yeni AI örümcekler oluştur
-    for (int i = 0; i < 50; ++i) {
-        float x = (rand() % 400 - 200) / 10.0f;
-        float z = (rand() % 400 - 200) / 10.0f;
+void printUsage() {
+    std::cerr << "Usage: ProjectSpider [--headless] [--ticks N] [--tick-rate HZ] [--threads N] [--seed N]"
+              << " [--record PATH | --replay PATH]\n"
+              << "  --ticks and --threads take a whole number >= 0, --tick-rate a number > 0,"
+              << " --seed a whole number from 0 to " << UINT32_MAX << "\n"
+              << "  --record only applies to a windowed run, so it cannot go with --headless or --replay"
+              << std::endl;
+}
 
-        // Yeni bir Spider nesnesi oluştur
-        spider::Spider newSpider(cephalothoraxShader, abdomenShader, legShader, eyeShader);
-        newSpider.setPosition(vec3(x, 0.7f, z));
-        newSpider.setScale(0.25f); // Make AI spiders smaller
+int usageError(const char* option, const char* value) {
+    std::cerr << "Invalid value for " << option << ": " << value << "\n";
+    printUsage();
+    return 1;
+}
 
-        // Vektöre ekle
-        aiSpiders.push_back(newSpider);
+// Options that must be followed by a value
+bool takesValue(const char* option) {
+    static const char* const OPTIONS[] = {"--replay", "--record", "--seed", "--ticks", "--tick-rate", "--threads"};
+    for (const char* known : OPTIONS) {
+        if (std::strcmp(option, known) == 0) {
+            return true;
+        }
     }
-
+    return false;
 }
 
+int main(int argc, char** argv) {
+    // --headless [--ticks N] [--tick-rate HZ] [--threads N]: step the simulation without a window.
+    // --tick-rate also sets the simulation rate of the windowed mode.
+    // --seed N fixes the world's random layout (default: the current time).
+    // --record PATH writes the seed, tick rate and per-tick player input of a windowed
+    // run on exit; --replay PATH plays such a log back headless, ending on the same state.
+    bool headless = false;
+    HeadlessOptions headlessOptions;
+    headlessOptions.seed = static_cast<uint32_t>(time(nullptr));
+    std::string recordPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            headless = true;
+            headlessOptions.replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            ++i;
+            if (!parseSeed(argv[i], headlessOptions.seed)) {
+                return usageError(argv[i - 1], argv[i]);
+            }
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ++i;
+            if (!parseCount(argv[i], headlessOptions.ticks)) {
+                return usageError(argv[i - 1], argv[i]);
+            }
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            ++i;
+            if (!parseRate(argv[i], headlessOptions.tickRate)) {
+                return usageError(argv[i - 1], argv[i]);
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            ++i;
+            if (!parseCount(argv[i], headlessOptions.threads)) {
+                return usageError(argv[i - 1], argv[i]);
+            }
+        } else {
+            std::cerr << (takesValue(argv[i]) ? "Missing value for " : "Unknown option ") << argv[i] << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (headless && !recordPath.empty()) {
+        std::cerr << "--record cannot be combined with --headless or --replay\n";
+        printUsage();
+        return 1;
+    }
+    if (headless) {
+        return runHeadless(headlessOptions);
+    }
 
-
-int main() {
-    srand(static_cast<unsigned>(time(nullptr)));
+    srand(headlessOptions.seed);
     //***********************************************************************************
     //***********************************************************************************
     // Initialize GLFW
@@ -84,6 +207,8 @@ int main() {
         return -1;
     }
 
+    GLFWSession session = {window};
+
     // Make the window's context current
     glfwMakeContextCurrent(window);
 
@@ -142,16 +267,15 @@ int main() {
         2, 3, 0
     };
 
-    GLuint groundVAO, groundVBO, groundEBO;
-    glGenVertexArrays(1, &groundVAO);
-    glGenBuffers(1, &groundVBO);
-    glGenBuffers(1, &groundEBO);
+    GLVertexArray groundVAO = GLVertexArray::create();
+    GLBuffer groundVBO = GLBuffer::create();
+    GLBuffer groundEBO = GLBuffer::create();
 
-    glBindVertexArray(groundVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
+    glBindVertexArray(groundVAO.get());
+    glBindBuffer(GL_ARRAY_BUFFER, groundVBO.get());
     glBufferData(GL_ARRAY_BUFFER, sizeof(groundVertices), groundVertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, groundEBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, groundEBO.get());
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(groundIndices), groundIndices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -164,9 +288,7 @@ int main() {
     glEnableVertexAttribArray(2);
     glBindVertexArray(0);
 
-    GLuint groundProgram = InitShader("shaders/ground_vertex.glsl", "shaders/ground_fragment.glsl");
-    GLuint groundMVLoc = glGetUniformLocation(groundProgram, "model_view");
-    GLuint groundPLoc  = glGetUniformLocation(groundProgram, "projection");
+    GLProgram groundProgram(InitShader("shaders/ground_vertex.glsl", "shaders/ground_fragment.glsl"));
 
     // Set the background color to purple
     glClearColor(0.5f, 0.5f, 0.5f, 0.5f);
@@ -177,60 +299,262 @@ int main() {
 
 
     // 1) Load and use shaders for the abdomen
-    GLuint cephalothoraxShader = InitShader("../shaders/spider_vertex.glsl", "../shaders/cephalothorax_fragment.glsl");
-    GLuint abdomenShader = InitShader("../shaders/spider_vertex.glsl", "../shaders/abdomen_fragment.glsl");
-    GLuint legShader = InitShader("../shaders/spider_vertex.glsl", "../shaders/leg_fragment.glsl");
-    GLuint eyeShader = InitShader("../shaders/spider_vertex.glsl", "../shaders/eye_fragment.glsl");
-    GLuint obstacleShader = InitShader("../shaders/obstacle_vertex.glsl", "../shaders/obstacle_fragment.glsl");
-    GLuint obstacleMVLoc = glGetUniformLocation(obstacleShader, "model_view");
-    GLuint obstaclePLoc = glGetUniformLocation(obstacleShader, "projection");
-    GLuint abdomenMVLoc   = glGetUniformLocation(abdomenShader, "model_view");
-    GLuint abdomenPLoc    = glGetUniformLocation(abdomenShader, "projection");
-    GLuint cephalothoraxMVLoc = glGetUniformLocation(cephalothoraxShader, "model_view");
-    GLuint cephalothoraxPLoc = glGetUniformLocation(cephalothoraxShader, "projection");
-    GLuint legMVLoc = glGetUniformLocation(legShader, "model_view");
-    GLuint legPLoc = glGetUniformLocation(legShader, "projection");
-    GLuint eyeMVLoc = glGetUniformLocation(eyeShader, "model_view");
-    GLuint eyePLoc = glGetUniformLocation(eyeShader, "projection");
-
-
-    spider::Spider spider(cephalothoraxShader, abdomenShader, legShader, eyeShader);
-    initAISpiders(cephalothoraxShader, abdomenShader, legShader, eyeShader);
+    GLProgram cephalothoraxShader(InitShader("../shaders/spider_vertex.glsl", "../shaders/cephalothorax_fragment.glsl"));
+    GLProgram abdomenShader(InitShader("../shaders/spider_vertex.glsl", "../shaders/abdomen_fragment.glsl"));
+    GLProgram legShader(InitShader("../shaders/spider_vertex.glsl", "../shaders/leg_fragment.glsl"));
+    GLProgram eyeShader(InitShader("../shaders/spider_vertex.glsl", "../shaders/eye_fragment.glsl"));
+    GLProgram obstacleShader(InitShader("../shaders/obstacle_vertex.glsl", "../shaders/obstacle_fragment.glsl"));
+    GLint obstacleModelLoc = glGetUniformLocation(obstacleShader.get(), "model");
+    GLint obstacleColorLoc = glGetUniformLocation(obstacleShader.get(), "uColor");
+
+
+    spider::SpiderRenderer spiderRenderer(cephalothoraxShader.get(), abdomenShader.get(), legShader.get(), eyeShader.get());
+
+    // Same fragment shaders, with the model matrix coming from the instance buffers
+    GLProgram cephalothoraxInstancedShader(InitShader("../shaders/spider_instanced_vertex.glsl", "../shaders/cephalothorax_fragment.glsl"));
+    GLProgram abdomenInstancedShader(InitShader("../shaders/spider_instanced_vertex.glsl", "../shaders/abdomen_fragment.glsl"));
+    GLProgram legInstancedShader(InitShader("../shaders/spider_instanced_vertex.glsl", "../shaders/leg_fragment.glsl"));
+    GLProgram eyeInstancedShader(InitShader("../shaders/spider_instanced_vertex.glsl", "../shaders/eye_fragment.glsl"));
+    spiderRenderer.enableInstancing(cephalothoraxInstancedShader.get(), abdomenInstancedShader.get(),
+                                    legInstancedShader.get(), eyeInstancedShader.get());
+    bool drawAIInstanced = true;   // I toggles between the instanced and the per-part path
+    GLProgram legFKShader(InitShader("../shaders/leg_fk_vertex.glsl", "../shaders/leg_fragment.glsl"));
+    spiderRenderer.enableGpuLegs(legFKShader.get());   // K switches leg kinematics back to the CPU
+    bool instancingKeyDown = false;
+    bool gpuLegsKeyDown = false;
+    spider::Spider& spider = world.player;
+    world.precomputeLegIK();
+    // The ground texture has drawn from rand() already; restart the sequence so
+    // the world is laid out exactly as runHeadless lays it out from the same seed
+    srand(headlessOptions.seed);
+    world.initAISpiders();
     camera.setPosition(spider.getPosition() + vec3(0.0f, 5.0f, 10.0f));
     camera.lookAt(spider.getPosition());
-    setupObstacles(obstacleShader);
+    world.setupObstacles(obstacleShader.get());
 
 
 
 
     // 2) setting the axes shader
-    GLuint axesProgram = InitShader("../shaders/axes_vertex.glsl", "../shaders/axes_fragment.glsl");
-    GLuint axesMVLoc   = glGetUniformLocation(axesProgram, "model_view");
-    GLuint axesPLoc    = glGetUniformLocation(axesProgram, "projection");
+    GLProgram axesProgram(InitShader("../shaders/axes_vertex.glsl", "../shaders/axes_fragment.glsl"));
 
-    Axes axes(axesProgram);
+    Axes axes(axesProgram.get());
 
-    float lastFrameTime = 0.0f;
+    // View and projection are uploaded once per frame into one buffer that every program reads
+    CameraUniforms cameraUniforms;
+    const GLuint cameraPrograms[] = {
+        groundProgram.get(), cephalothoraxShader.get(), abdomenShader.get(), legShader.get(), eyeShader.get(),
+        obstacleShader.get(), cephalothoraxInstancedShader.get(), abdomenInstancedShader.get(),
+        legInstancedShader.get(), eyeInstancedShader.get(), legFKShader.get(), axesProgram.get()
+    };
+    for (GLuint program : cameraPrograms) {
+        CameraUniforms::attach(program);
+    }
 
-    // 4) Main render loop
-    while(!glfwWindowShouldClose(window)) {
-        float currentFrameTime = static_cast<float>(glfwGetTime());
-        float deltaTime = currentFrameTime - lastFrameTime;
-        lastFrameTime = currentFrameTime;
-
-        for (size_t i = 0; i < aiSpiders.size(); ++i) {
-            auto& ai = aiSpiders[i];
-            float t = static_cast<float>(glfwGetTime()) + i * 1.8f;
-            ai.startWalkingForward();
-            if (fmod(t, 4.0f) < 2.0f) {
-                ai.startTurningLeft();
-                ai.stopTurningRight();
+    // The ground always samples unit 0
+    glUseProgram(groundProgram.get());
+    glUniform1i(glGetUniformLocation(groundProgram.get(), "checkerTex"), 0);
+
+    DrawPacket groundPacket;
+    groundPacket.program = groundProgram.get();
+    groundPacket.vertexArray = groundVAO.get();
+    groundPacket.count = 6;
+    groundPacket.texture = checkerTexture;
+
+    RenderQueue renderQueue;
+    GpuTimer gpuTimer;
+    std::cout << "GPU pass timing: " << (gpuTimer.isSupported() ? "timestamp queries" : "not supported") << std::endl;
+    std::vector<spider::SpiderState> visibleAIPoses;
+    std::vector<int> visibleAILods;
+
+    JobSystem jobSystem;
+    FramePipeline framePipeline(world, jobSystem);
+    std::cout << "Job system workers: " << jobSystem.getWorkerCount() << std::endl;
+    spider::MeshRegistryStats meshStats = spider::MeshRegistry::instance().getStats();
+    std::cout << "Meshes: " << meshStats.meshes << " resident (" << meshStats.builds << " built, "
+              << meshStats.reuses << " shared), " << meshStats.gpuBytes << " GPU bytes, "
+              << meshStats.cpuBytes << " CPU bytes" << std::endl;
+
+    TripleBuffer<FrameSnapshot> snapshots;
+    TripleBuffer<RenderReport> reports;
+    std::atomic<uint64_t> framePickedUp(0);   // newest snapshot the render thread has taken
+    std::atomic<bool> rendering(true);
+    // The snapshots themselves go through the lock-free buffers; these only put
+    // the idle side to sleep: the renderer until a snapshot is published, the
+    // simulation until the renderer has taken the previous one
+    std::mutex handoffMutex;
+    std::condition_variable snapshotPublished;
+    std::condition_variable snapshotTaken;
+
+    // 4) Render loop, on its own thread from here on: it owns the GL context and
+    // draws snapshot N while the main thread simulates frame N + 1
+    glfwMakeContextCurrent(nullptr);
+    std::thread renderThread([&]() {
+        PROFILE_THREAD_NAME("render");
+        glfwMakeContextCurrent(window);
+        RenderReport report;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(handoffMutex);
+                snapshotPublished.wait(lock, [&] {
+                    return !rendering.load(std::memory_order_acquire) || snapshots.acquire();
+                });
+            }
+            if (!rendering.load(std::memory_order_acquire)) {
+                break;
+            }
+            PROFILE_SCOPE("render frame");
+            const FrameSnapshot& frame = snapshots.front();
+            {
+                std::lock_guard<std::mutex> lock(handoffMutex);
+                framePickedUp.store(frame.frame, std::memory_order_release);
+            }
+            snapshotTaken.notify_one();
+            double renderStart = glfwGetTime();
+            resetDrawStats();
+            spiderRenderer.setGpuLegsActive(frame.gpuLegs);
+
+            mat4 Projection = Perspective( 45.0f, 4.0f/3.0f, 0.1f, 100.0f );
+            const mat4& View = frame.view;
+            cameraUniforms.update(View, Projection);
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            gpuTimer.beginFrame();
+
+
+            // axes.draw(glGetUniformLocation(axesProgram.get(), "model"), mat4());
+
+            // Obstacles, the player, the ground and (on the per-part path) the AI spiders
+            // go through the queue, which sorts them by program and mesh. Each pass is
+            // flushed on its own so the GPU timer can put a timestamp between them.
+            // Anything whose bounding sphere is outside the view never reaches matrix building
+            ViewFrustum frustum(Projection * View);
+            size_t obstaclesVisible = 0;
+            // Level of detail follows the projected size, so it needs the framebuffer height
+            spiderRenderer.selectVisible(frame.aiPoses, frustum, View, Projection,
+                                         static_cast<float>(frame.framebufferHeight), visibleAIPoses, visibleAILods);
+
+            renderQueue.begin(View);
+            for (const ObstacleDraw& obs : frame.obstacles) {
+                if (obs.isVisible(frustum)) {
+                    obs.enqueue(renderQueue, obstacleModelLoc, obstacleColorLoc);
+                    ++obstaclesVisible;
+                }
+            }
+            renderQueue.flush();
+            gpuTimer.endPass(GPU_PASS_OBSTACLES);
+
+            if (frame.drawAIInstanced) {
+                spiderRenderer.drawInstanced(visibleAIPoses, visibleAILods);
             } else {
-                ai.startTurningRight();
-                ai.stopTurningLeft();
+                for (size_t i = 0; i < visibleAIPoses.size(); ++i) {
+                    spiderRenderer.enqueue(visibleAIPoses[i], renderQueue, visibleAILods[i]);
+                }
+                PROFILE_SCOPE("RenderQueue::flush");
+                renderQueue.flush();
             }
-            ai.update(deltaTime);
+            gpuTimer.endPass(GPU_PASS_AI_SPIDERS);
+
+            spiderRenderer.enqueue(frame.player, renderQueue, 0, 0.5f);
+            renderQueue.flush();
+            gpuTimer.endPass(GPU_PASS_PLAYER);
+
+            renderQueue.push(groundPacket);
+            renderQueue.flush();
+            gpuTimer.endPass(GPU_PASS_GROUND);
+
+            recordCulling(obstaclesVisible + visibleAIPoses.size(),
+                          (frame.obstacles.size() - obstaclesVisible) + (frame.aiPoses.size() - visibleAIPoses.size()));
+
+
+
+            // Position health bar to top-right using OpenGL overlay (drawn with immediate mode)
+            int health = std::max(0, 10 - frame.score); // Health from 10 to 0
+            glMatrixMode(GL_PROJECTION);
+            glPushMatrix();
+            glLoadIdentity();
+            glOrtho(0, 800, 600, 0, -1, 1); // Top-left origin
+
+            glMatrixMode(GL_MODELVIEW);
+            glPushMatrix();
+            glLoadIdentity();
+
+            glDisable(GL_DEPTH_TEST);
+
+            for (int i = 0; i < 10; ++i) {
+                if (i >= health) glColor3f(0.3f, 0.3f, 0.3f); // gray (empty)
+                else glColor3f(0.0f, 1.0f, 0.0f); // green (full)
+
+                float barWidth = 12;
+                float barHeight = 20;
+                float spacing = 3;
+                float x = 800 - (barWidth + spacing) * (10 - i) - 10;
+                float y = 560; // push closer to top edge
+
+                glBegin(GL_QUADS);
+                glVertex2f(x, y);
+                glVertex2f(x + barWidth, y);
+                glVertex2f(x + barWidth, y + barHeight);
+                glVertex2f(x, y + barHeight);
+                glEnd();
+            }
+
+            glEnable(GL_DEPTH_TEST);
+            glPopMatrix();
+
+            glMatrixMode(GL_PROJECTION);
+            glPopMatrix();
+            glMatrixMode(GL_MODELVIEW);
+            gpuTimer.endPass(GPU_PASS_OVERLAY);
+
+            // Busy time stops before the swap, which may block on vsync
+            report.frame = frame.frame;
+            ++report.framesRendered;
+            report.busySeconds += glfwGetTime() - renderStart;
+            report.drawStats = getDrawStats();
+            report.queueStats = renderQueue.getStats();
+            report.gpuTimed = gpuTimer.isSupported();
+            report.gpuDroppedFrames = gpuTimer.getDroppedFrames();
+            for (int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+                report.gpuPasses[pass] = gpuTimer.getStats(static_cast<GpuPass>(pass));
+            }
+            reports.back() = report;
+            reports.publish();
+
+            PROFILE_SCOPE("glfwSwapBuffers");
+            glfwSwapBuffers(window);
         }
+        glfwMakeContextCurrent(nullptr);
+    });
+
+    // 5) Simulation loop: input, as many fixed ticks as the frame's wall time covers,
+    // and the snapshot for the render thread, blended between the last two ticks
+    FixedTimestep simClock(headlessOptions.tickRate, SIM_MAX_TICKS_PER_FRAME);
+    spider::SpiderState previousPlayer = spider.getState();
+    double lastFrameTime = glfwGetTime();
+    bool gpuLegs = spiderRenderer.isGpuLegsActive();
+    uint64_t frameNumber = 0;
+    RenderReport lastReport;
+
+    // Overlap is measured over the same windows as the title refresh, and over the whole run
+    const double loopStart = glfwGetTime();
+    double statsWindowStart = loopStart;
+    double simBusyInWindow = 0.0, simBusyTotal = 0.0;
+    uint64_t simFramesInWindow = 0;
+    uint64_t windowStartTicks = 0;
+    RenderReport windowStartReport;
+    bool traceKeyDown = false;
+    bool jumpPending = false;
+    InputLog inputLog;
+    inputLog.seed = headlessOptions.seed;
+    inputLog.tickRate = headlessOptions.tickRate;
+    PROFILE_THREAD_NAME("simulation");
+
+    while(!glfwWindowShouldClose(window)) {
+        PROFILE_SCOPE("simulation frame");
+        double simStart = glfwGetTime();
+        simClock.beginFrame(simStart - lastFrameTime);
+        lastFrameTime = simStart;
 
         // keyboard
         if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) camera.processKeyboard(GLFW_KEY_W);
@@ -251,202 +575,183 @@ int main() {
         if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)    camera.processKeyboard(GLFW_KEY_UP);
         if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)  camera.processKeyboard(GLFW_KEY_DOWN);
 
-        // Spider movement
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-            spider.startWalkingForward();
-        } else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-            spider.startWalkingBackward();
-        } else {
-            spider.stopWalkingForward();
-            spider.stopWalkingBackward();
+        // Spider movement, applied once per tick below so a recording can replay it tick for tick
+        uint8_t playerInput = 0;
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) playerInput |= PLAYER_INPUT_FORWARD;
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) playerInput |= PLAYER_INPUT_BACKWARD;
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) playerInput |= PLAYER_INPUT_TURN_LEFT;
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) playerInput |= PLAYER_INPUT_TURN_RIGHT;
+        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) playerInput |= PLAYER_INPUT_BODY_UP;
+        if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS) playerInput |= PLAYER_INPUT_BODY_DOWN;
+        // A jump press waits for the next tick, even if this frame runs none
+        if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) jumpPending = true;
+
+        // AI update, leg IK, player update, collisions and pose evaluation on the job
+        // system, 0..SIM_MAX_TICKS_PER_FRAME times depending on how much time has built up
+        CollisionEvents collisions;
+        while (simClock.tick()) {
+            previousPlayer = spider.getState();
+            uint8_t tickInput = playerInput;
+            if (jumpPending) {
+                tickInput |= PLAYER_INPUT_JUMP;
+                jumpPending = false;
+            }
+            applyPlayerInput(spider, tickInput);
+            if (!recordPath.empty()) {
+                inputLog.ticks.push_back(tickInput);
+            }
+            CollisionEvents tickCollisions = framePipeline.run(simClock.getTickTime(), simClock.getTickSeconds());
+            collisions.obstaclesHit += tickCollisions.obstaclesHit;
+            collisions.spidersEaten += tickCollisions.spidersEaten;
         }
 
-        // Add turning logic here
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-            spider.startTurningLeft();
-        } else {
-            spider.stopTurningLeft();
+        bool instancingKeyPressed = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+        if (instancingKeyPressed && !instancingKeyDown) {
+            drawAIInstanced = !drawAIInstanced;
         }
+        instancingKeyDown = instancingKeyPressed;
 
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-            spider.startTurningRight();
-        } else {
-            spider.stopTurningRight();
+        bool gpuLegsKeyPressed = glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS;
+        if (gpuLegsKeyPressed && !gpuLegsKeyDown) {
+            gpuLegs = !gpuLegs;
         }
+        gpuLegsKeyDown = gpuLegsKeyPressed;
 
-        // Spider movement
-        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
-            spider.moveBodyUp();
-        } else if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS) {
-            spider.moveBodyDown();
+        // P writes the trace rings to disk without stopping; only does anything in profiling builds
+        bool traceKeyPressed = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+        if (traceKeyPressed && !traceKeyDown) {
+            PROFILE_DUMP(PROFILE_TRACE_PATH);
         }
-
-       if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS ) {
-            spider.jumpTriggered = true; // Define and initialize the global variable
-       }
-
-        for (size_t i = 0; i < aiSpiders.size(); ++i) {
-            auto& ai = aiSpiders[i];
-            float t = static_cast<float>(glfwGetTime()) + i * 1.8f;
-
-            ai.startWalkingForward();
-
-            if (fmod(t, 4.0f) < 2.0f) {
-                ai.startTurningLeft();
-                ai.stopTurningRight();
-            } else {
-                ai.startTurningRight();
-                ai.stopTurningLeft();
-            }
-
-            ai.update(deltaTime);
-        }
-
-
-        // Add other spider controls here if needed (e.g., turning)
-
-        spider.update(deltaTime);
-
-        vec3 spiderPos = spider.getPosition();
+        traceKeyDown = traceKeyPressed;
+
+        // Fill the back snapshot; it still holds the frame from two publishes ago,
+        // so the vectors reuse their storage
+        PROFILE_SCOPE("snapshot and hand-off");
+        FrameSnapshot& snapshot = snapshots.back();
+        snapshot.frame = ++frameNumber;
+        const float alpha = simClock.getAlpha();
+        snapshot.player = spider::interpolate(previousPlayer, spider.getState(), alpha);
+        spider::interpolateStates(framePipeline.getPreviousAIPoses(), framePipeline.getAIPoses(), alpha, snapshot.aiPoses);
+
+        // The camera follows the drawn player, not the last tick, so it moves as smoothly
+        vec3 spiderPos = snapshot.player.position;
         camera.setPosition(spiderPos + vec3(0.0f, 5.0f, 15.0f));  // Yüksekliği ve uzaklığı ayarla
         camera.lookAt(spiderPos);
-
-        vec3 spiderPosCollision = spider.getPosition(); // Assumes getPosition() returns current position of spider
-
-        // Check collision with obstacles
-        for (auto it = obstacles.begin(); it != obstacles.end(); ) {
-            vec3 diff = spiderPosCollision - it->getPosition();
-            float dist = sqrt(dot(diff, diff));
-            if (dist < 1.0f) { // Adjust collision threshold if needed
-                score += it->getPointValue();
-                std::cout << "Collision with obstacle! Score: " << score << std::endl;
-
-                // Display score as overlay using OpenGL
-                std::string scoreText = "Score: " + std::to_string(score);
-                glfwSetWindowTitle(window, scoreText.c_str());
-
-                it = obstacles.erase(it); // Remove obstacle after collision
-            } else {
-                ++it;
-            }
+        snapshot.view = camera.getViewMatrix();
+        int framebufferWidth = 0;
+        glfwGetFramebufferSize(window, &framebufferWidth, &snapshot.framebufferHeight);
+        snapshot.obstacles.clear();
+        for (const Obstacle& obs : world.obstacles) {
+            snapshot.obstacles.push_back(obs.getDrawRecord());
         }
+        snapshot.score = world.score;
+        snapshot.drawAIInstanced = drawAIInstanced;
+        snapshot.gpuLegs = gpuLegs;
+
+        double simSeconds = glfwGetTime() - simStart;
+        simBusyInWindow += simSeconds;
+        simBusyTotal += simSeconds;
+        ++simFramesInWindow;
+
+        // Stay at most one frame ahead: frame N is published only once the render
+        // thread has taken N - 1, so it renders N - 1 while we simulate N
+        {
+            PROFILE_SCOPE("wait for render");
+            std::unique_lock<std::mutex> lock(handoffMutex);
+            snapshotTaken.wait(lock, [&] {
+                return framePickedUp.load(std::memory_order_acquire) + 1 >= snapshot.frame;
+            });
+            snapshots.publish();
+        }
+        snapshotPublished.notify_one();
 
-        // Check collision with AI spiders
-        for (auto it = aiSpiders.begin(); it != aiSpiders.end(); ) {
-            vec3 diff = spiderPosCollision - it->getPosition();
-            float dist = sqrt(dot(diff, diff));
-            if (dist < 1.5f) { // Slightly larger threshold for spiders
-                score += 10; // Add points for eating a spider
-                std::cout << "Spider eaten! Score: " << score << std::endl;
-
-                // Display score as overlay using OpenGL
-                std::string scoreText = "Score: " + std::to_string(score);
-                glfwSetWindowTitle(window, scoreText.c_str());
-
-                it = aiSpiders.erase(it); // Remove the eaten spider
-
-                // Increase player spider's size when it eats an AI spider
-                float currentScale = spider.getScale();
-                spider.setScale(currentScale + 0.1f); // Grow by 5% each time
-                std::cout << "Spider grew! New scale: " << spider.getScale() << std::endl;
-
-                // If all spiders are eaten, spawn new ones
-                if (aiSpiders.empty()) {
-                    initAISpiders(cephalothoraxShader, abdomenShader, legShader, eyeShader);
+        // Score, the last rendered frame's draw calls and queue state changes, and how
+        // well simulation and rendering overlapped, refreshed on a score change and once a second
+        if (reports.acquire()) {
+            lastReport = reports.front();
+        }
+        double now = glfwGetTime();
+        if (collisions.obstaclesHit > 0 || collisions.spidersEaten > 0 || now - statsWindowStart > 1.0) {
+            const DrawStats& drawStats = lastReport.drawStats;
+            const RenderQueueStats& queueStats = lastReport.queueStats;
+            double renderBusy = lastReport.busySeconds - windowStartReport.busySeconds;
+            uint64_t renderFrames = lastReport.framesRendered - windowStartReport.framesRendered;
+            double overlap = overlapEfficiency(simBusyInWindow, renderBusy, now - statsWindowStart);
+            std::ostringstream pipelineText;
+            pipelineText << std::fixed << std::setprecision(1)
+                         << " | sim " << 1000.0 * simBusyInWindow / std::max<uint64_t>(simFramesInWindow, 1)
+                         << " ms, render " << 1000.0 * renderBusy / std::max<uint64_t>(renderFrames, 1)
+                         << " ms, overlap " << std::setprecision(0) << 100.0 * overlap << "%"
+                         << " | " << (simClock.getTickCount() - windowStartTicks) / (now - statsWindowStart) << " ticks/s";
+            if (lastReport.gpuTimed) {
+                float gpuMs = 0.0f;
+                for (const GpuPassStats& pass : lastReport.gpuPasses) {
+                    gpuMs += pass.average;
                 }
-            } else {
-                ++it;
+                pipelineText << std::setprecision(2) << " | GPU " << gpuMs << " ms";
             }
+            std::string scoreText = "Score: " + std::to_string(world.score) +
+                                    " | draw calls: " + std::to_string(drawStats.drawCalls) +
+                                    (drawAIInstanced ? " (instanced)" : " (per part)") +
+                                    (drawAIInstanced && gpuLegs ? ", GPU legs" : "") +
+                                    " | binds: " + std::to_string(queueStats.programChanges) + " programs, " +
+                                    std::to_string(queueStats.vertexArrayChanges) + " VAOs" +
+                                    " | visible: " + std::to_string(drawStats.visible) + "/" +
+                                    std::to_string(drawStats.visible + drawStats.culled) +
+                                    " | triangles: " + std::to_string(drawStats.triangles) +
+                                    pipelineText.str();
+            glfwSetWindowTitle(window, scoreText.c_str());
+            statsWindowStart = now;
+            simBusyInWindow = 0.0;
+            simFramesInWindow = 0;
+            windowStartTicks = simClock.getTickCount();
+            windowStartReport = lastReport;
         }
 
+        glfwPollEvents();
+    }
 
-        mat4 Projection = Perspective( 45.0f, 4.0f/3.0f, 0.1f, 100.0f );
-        mat4 View       = camera.getViewMatrix();
-        mat4 axesMV = View;
-
-        glUniformMatrix4fv(projLoc, 1, GL_TRUE, Projection);
-        glUniformMatrix4fv(mvLoc,   1, GL_TRUE, axesMV);
-
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-
-        // axes.draw(axesMVLoc, axesPLoc, axesMV, Projection);
-
-        for (auto& obs : obstacles) {
-            obs.draw(obstacleMVLoc, obstaclePLoc, View, Projection);
-        }
+    {
+        std::lock_guard<std::mutex> lock(handoffMutex);
+        rendering.store(false, std::memory_order_release);
+    }
+    snapshotPublished.notify_one();
+    renderThread.join();
+    glfwMakeContextCurrent(window);
 
-        for (auto& aiSpider : aiSpiders) {
-            aiSpider.drawAllComponents(cephalothoraxMVLoc, cephalothoraxPLoc,
-                                      abdomenMVLoc, abdomenPLoc,
-                                      legMVLoc, legPLoc,
-                                      eyeMVLoc, eyePLoc,
-                                      View, Projection);
+    if (reports.acquire()) {
+        lastReport = reports.front();
+    }
+    double runSeconds = glfwGetTime() - loopStart;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Frames: " << frameNumber << " built, " << lastReport.framesRendered << " rendered; "
+              << simClock.getTickCount() << " ticks at " << headlessOptions.tickRate << " Hz ("
+              << simClock.getDroppedSeconds() << " s dropped by the tick clamp); "
+              << "sim " << 1000.0 * simBusyTotal / std::max<uint64_t>(frameNumber, 1) << " ms/frame, "
+              << "render " << 1000.0 * lastReport.busySeconds / std::max<uint64_t>(lastReport.framesRendered, 1)
+              << " ms/frame, overlap " << 100.0 * overlapEfficiency(simBusyTotal, lastReport.busySeconds, runSeconds)
+              << "%" << std::endl;
+    if (lastReport.gpuTimed) {
+        std::cout << "GPU time per pass over the last " << lastReport.gpuPasses[0].samples << " measured frames ("
+                  << lastReport.gpuDroppedFrames << " frames dropped while still pending), ms avg / p50 / p95 / p99:\n";
+        for (int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+            const GpuPassStats& stats = lastReport.gpuPasses[pass];
+            std::cout << "  " << std::left << std::setw(12) << GpuTimer::getPassName(static_cast<GpuPass>(pass)) << std::right
+                      << std::setprecision(3) << stats.average << " / " << stats.p50 << " / " << stats.p95 << " / "
+                      << stats.p99 << "\n";
         }
+        std::cout << std::flush;
+    }
+    PROFILE_DUMP(PROFILE_TRACE_PATH);
 
-
-
-        glUseProgram(abdomenShader);
-        spider.draw(abdomenMVLoc, abdomenPLoc, View, Projection);
-
-
-
-        // Draw ground
-        glUseProgram(groundProgram);
-        glUniformMatrix4fv(groundMVLoc, 1, GL_TRUE, View);
-        glUniformMatrix4fv(groundPLoc,  1, GL_TRUE, Projection);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, checkerTexture);
-        glUniform1i(glGetUniformLocation(groundProgram, "checkerTex"), 0);
-
-        glBindVertexArray(groundVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-
-
-
-        // Position health bar to top-right using OpenGL overlay (drawn with immediate mode)
-        int health = std::max(0, 10 - score); // Health from 10 to 0
-        glMatrixMode(GL_PROJECTION);
-        glPushMatrix();
-        glLoadIdentity();
-        glOrtho(0, 800, 600, 0, -1, 1); // Top-left origin
-
-        glMatrixMode(GL_MODELVIEW);
-        glPushMatrix();
-        glLoadIdentity();
-
-        glDisable(GL_DEPTH_TEST);
-
-        for (int i = 0; i < 10; ++i) {
-            if (i >= health) glColor3f(0.3f, 0.3f, 0.3f); // gray (empty)
-            else glColor3f(0.0f, 1.0f, 0.0f); // green (full)
-
-            float barWidth = 12;
-            float barHeight = 20;
-            float spacing = 3;
-            float x = 800 - (barWidth + spacing) * (10 - i) - 10;
-            float y = 560; // push closer to top edge
-
-            glBegin(GL_QUADS);
-            glVertex2f(x, y);
-            glVertex2f(x + barWidth, y);
-            glVertex2f(x + barWidth, y + barHeight);
-            glVertex2f(x, y + barHeight);
-            glEnd();
+    std::cout << "Seed " << headlessOptions.seed << ", state hash 0x" << std::hex << world.stateHash() << std::dec << std::endl;
+    if (!recordPath.empty()) {
+        if (writeInputLog(recordPath, inputLog)) {
+            std::cout << "Recorded " << inputLog.ticks.size() << " ticks to " << recordPath
+                      << "; replay with --replay " << recordPath << std::endl;
+        } else {
+            std::cerr << "Could not write input log " << recordPath << std::endl;
         }
-
-        glEnable(GL_DEPTH_TEST);
-        glPopMatrix();
-
-        glMatrixMode(GL_PROJECTION);
-        glPopMatrix();
-        glMatrixMode(GL_MODELVIEW);
-
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
     }
 
 
@@ -456,40 +761,11 @@ int main() {
 
     //***********************************************************************************
     //***********************************************************************************
-    // Cleanup
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    // Cleanup: the obstacles live in the global World, so release their buffers while the context exists
+    world.obstacles.clear();
+    Model::releaseAll();
+    spider::LegSegment::cleanupShared();
     return 0;
 
 
 }
-
-void setupObstacles(GLuint shaderProgram) {
-    for (int i = 0; i < 10; ++i) {
-        float x = static_cast<float>((rand() % 400 - 200) / 10.0f); // -20.0f to +20.0f
-        float z = static_cast<float>((rand() % 400 - 200) / 10.0f);
-        int type = rand() % 4;
-        int pointValue;
-        std::string modelPath;
-        switch (type) {
-            case 0: // Kale
-                pointValue = 5;
-                modelPath = "models/rook.stl";
-                break;
-            case 1: // Vezir
-                pointValue = 3;
-                modelPath = "models/queen.stl";
-                break;
-            case 2: // Piyon
-                pointValue = 1;
-                modelPath = "models/pawn.stl";
-                break;
-            case 3: // Engelleyici taş
-            default:
-                pointValue = -2;
-                modelPath = "models/blocker.stl";
-                break;
-        }
-        obstacles.push_back(Obstacle(vec3(x, 0.5f, z), 1.0f, pointValue, shaderProgram, modelPath));
-    }
-}
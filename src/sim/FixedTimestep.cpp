@@ -0,0 +1,47 @@
+// Description: Source file for FixedTimestep.
+#include "sim/FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(float tickRate, int maxTicksPerFrame)
+    : tickSeconds_(1.0 / tickRate), maxTicksPerFrame_(maxTicksPerFrame > 0 ? maxTicksPerFrame : 1),
+      accumulator_(0.0), ticks_(0), droppedSeconds_(0.0) {}
+
+void FixedTimestep::beginFrame(double frameSeconds) {
+    if (frameSeconds > 0.0) {
+        accumulator_ += frameSeconds;
+    }
+    const double limit = maxTicksPerFrame_ * tickSeconds_;
+    if (accumulator_ > limit) {
+        droppedSeconds_ += accumulator_ - limit;
+        accumulator_ = limit;
+    }
+}
+
+bool FixedTimestep::tick() {
+    if (accumulator_ < tickSeconds_) {
+        return false;
+    }
+    accumulator_ -= tickSeconds_;
+    ++ticks_;
+    return true;
+}
+
+float FixedTimestep::getTickSeconds() const {
+    return static_cast<float>(tickSeconds_);
+}
+
+float FixedTimestep::getTickTime() const {
+    // From the tick count rather than a running sum, so the clock never drifts
+    return ticks_ == 0 ? 0.0f : static_cast<float>((ticks_ - 1) * tickSeconds_);
+}
+
+float FixedTimestep::getAlpha() const {
+    return static_cast<float>(accumulator_ / tickSeconds_);
+}
+
+uint64_t FixedTimestep::getTickCount() const {
+    return ticks_;
+}
+
+double FixedTimestep::getDroppedSeconds() const {
+    return droppedSeconds_;
+}
@@ -0,0 +1,69 @@
+// Description: Source file for FramePipeline.
+#include "sim/FramePipeline.h"
+#include "utils/Profiler.h"
+
+namespace {
+    const size_t POSE_GRAIN_SIZE = 64;
+}
+
+FramePipeline::FramePipeline(World& world, JobSystem& jobs, bool evaluatePoses)
+    : world_(world), jobs_(jobs), evaluatePoses_(evaluatePoses), time_(0.0f), deltaTime_(0.0f) {
+    buildGraph();
+}
+
+void FramePipeline::buildGraph() {
+    TaskGraph::TaskId aiLocomotion = graph_.add("ai_locomotion", [this] {
+        world_.updateAILocomotion(jobs_, time_, deltaTime_);
+    });
+    TaskGraph::TaskId aiLegIK = graph_.add("ai_leg_ik", [this] {
+        world_.solveAILegIK(jobs_);
+    });
+    TaskGraph::TaskId aiSpatialIndex = graph_.add("ai_spatial_index", [this] {
+        world_.updateAISpatialIndex();
+    });
+    TaskGraph::TaskId player = graph_.add("player_update", [this] {
+        world_.player.update(deltaTime_);
+    });
+    TaskGraph::TaskId collisions = graph_.add("collisions", [this] {
+        collisions_ = world_.checkCollisions();
+    });
+    TaskGraph::TaskId poses = graph_.add("ai_poses", [this] {
+        if (!evaluatePoses_) {
+            return;
+        }
+        aiPoses_.resize(world_.aiSpiders.size());
+        jobs_.parallelFor(aiPoses_.size(), POSE_GRAIN_SIZE, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                aiPoses_[i] = world_.aiSpiders.stateAt(i);
+            }
+        });
+    });
+
+    graph_.precede(aiLocomotion, aiLegIK);
+    graph_.precede(aiLocomotion, aiSpatialIndex);
+    graph_.precede(aiSpatialIndex, collisions);
+    // Collisions remove spiders, so nothing may still be writing their components
+    graph_.precede(aiLegIK, collisions);
+    graph_.precede(player, collisions);
+    graph_.precede(collisions, poses);
+}
+
+CollisionEvents FramePipeline::run(float time, float deltaTime) {
+    PROFILE_SCOPE("FramePipeline::run");
+    time_ = time;
+    deltaTime_ = deltaTime;
+    collisions_ = CollisionEvents();
+    if (evaluatePoses_) {
+        aiPoses_.swap(previousAIPoses_);
+    }
+    jobs_.run(graph_);
+    return collisions_;
+}
+
+const std::vector<spider::SpiderState>& FramePipeline::getAIPoses() const {
+    return aiPoses_;
+}
+
+const std::vector<spider::SpiderState>& FramePipeline::getPreviousAIPoses() const {
+    return previousAIPoses_;
+}
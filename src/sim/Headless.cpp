@@ -0,0 +1,79 @@
+// Description: Source file for the headless runner.
+#include "sim/Headless.h"
+#include "sim/World.h"
+#include "sim/FramePipeline.h"
+#include "sim/InputLog.h"
+#include "spider/LegIKCache.h"
+#include "spider/LegIKSolver.h"
+#include "utils/JobSystem.h"
+#include "utils/Profiler.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int runHeadless(const HeadlessOptions& requested) {
+    HeadlessOptions options = requested;
+    InputLog replay;
+    if (!options.replayPath.empty()) {
+        if (!readInputLog(options.replayPath, replay)) {
+            std::cerr << "Could not read input log " << options.replayPath << std::endl;
+            return 1;
+        }
+        options.seed = replay.seed;
+        options.tickRate = replay.tickRate;
+        options.ticks = static_cast<int>(replay.ticks.size());
+    }
+    srand(options.seed);
+
+    World world;
+    auto precomputeStart = std::chrono::steady_clock::now();
+    world.precomputeLegIK();
+    double precomputeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - precomputeStart).count();
+    world.initAISpiders();
+    world.setupObstacles(0); // no shader program: obstacles are never drawn headless
+
+    JobSystem jobs(options.threads > 0 ? static_cast<unsigned>(options.threads) : JobSystem::defaultWorkerCount());
+    FramePipeline pipeline(world, jobs, false); // nothing is drawn, skip pose evaluation
+
+    // Tick times computed like FixedTimestep's, so a replay sees the windowed run's floats
+    const double tickSeconds = 1.0 / options.tickRate;
+    const float deltaTime = static_cast<float>(tickSeconds);
+    int obstaclesHit = 0;
+    int spidersEaten = 0;
+
+    spider::resetLegIKCounters();
+    spider::LegIKCache& ikCache = spider::LegIKCache::instance();
+    ikCache.resetStats();
+    PROFILE_THREAD_NAME("simulation");
+    auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < options.ticks; ++tick) {
+        float simTime = static_cast<float>(tick * tickSeconds);
+
+        if (!replay.ticks.empty()) {
+            applyPlayerInput(world.player, replay.ticks[tick]);
+        }
+        CollisionEvents events = pipeline.run(simTime, deltaTime);
+        obstaclesHit += events.obstaclesHit;
+        spidersEaten += events.spidersEaten;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    spider::LegIKCounters ik = spider::getLegIKCounters();
+    spider::LegIKCacheStats cacheStats = ikCache.getStats();
+    std::cout << "Headless run: " << options.ticks << " ticks at " << options.tickRate << " Hz on " << jobs.getWorkerCount() << " workers"
+              << (replay.ticks.empty() ? "" : ", replaying " + options.replayPath) << "\n"
+              << "  seed:           " << options.seed << "\n"
+              << "  simulated time: " << options.ticks * deltaTime << " s\n"
+              << "  wall time:      " << seconds << " s\n"
+              << "  ticks/s:        " << (seconds > 0.0 ? options.ticks / seconds : 0.0) << "\n"
+              << "  AI spiders:     " << world.aiSpiders.size() << "\n"
+              << "  obstacles hit:  " << obstaclesHit << ", spiders eaten: " << spidersEaten
+              << ", score: " << world.score << "\n"
+              << "  leg IK solves:  " << ik.executed << " executed, " << ik.skipped << " skipped (inputs unchanged)\n"
+              << "  IK cache:       " << (ikCache.isEnabled() ? "" : "disabled, ") << cacheStats.entries << " entries (precomputed in "
+              << precomputeSeconds << " s), " << cacheStats.hits << " hits, " << cacheStats.misses << " misses\n"
+              << "  state hash:     0x" << std::hex << world.stateHash() << std::dec << std::endl;
+    PROFILE_DUMP(PROFILE_TRACE_PATH);
+    return 0;
+}
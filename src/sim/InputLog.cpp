@@ -0,0 +1,137 @@
+// Description: Source file for the input log.
+#include "sim/InputLog.h"
+#include "spider/Spider.h"
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    const char MAGIC[4] = {'S', 'P', 'I', 'L'};
+    const uint32_t VERSION = 1;
+
+    // Fixed little-endian encoding, so a log plays back on any machine
+    void putU32(std::ostream& out, uint32_t value) {
+        char bytes[4];
+        for (int i = 0; i < 4; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+        out.write(bytes, 4);
+    }
+
+    void putU64(std::ostream& out, uint64_t value) {
+        putU32(out, static_cast<uint32_t>(value));
+        putU32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    bool getU32(std::istream& in, uint32_t& value) {
+        unsigned char bytes[4];
+        if (!in.read(reinterpret_cast<char*>(bytes), 4)) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+        }
+        return true;
+    }
+
+    bool getU64(std::istream& in, uint64_t& value) {
+        uint32_t low = 0, high = 0;
+        if (!getU32(in, low) || !getU32(in, high)) {
+            return false;
+        }
+        value = (static_cast<uint64_t>(high) << 32) | low;
+        return true;
+    }
+}
+
+void applyPlayerInput(spider::Spider& player, uint8_t input) {
+    if (input & PLAYER_INPUT_FORWARD) {
+        player.startWalkingForward();
+    } else if (input & PLAYER_INPUT_BACKWARD) {
+        player.startWalkingBackward();
+    } else {
+        player.stopWalkingForward();
+        player.stopWalkingBackward();
+    }
+
+    if (input & PLAYER_INPUT_TURN_LEFT) {
+        player.startTurningLeft();
+    } else {
+        player.stopTurningLeft();
+    }
+
+    if (input & PLAYER_INPUT_TURN_RIGHT) {
+        player.startTurningRight();
+    } else {
+        player.stopTurningRight();
+    }
+
+    if (input & PLAYER_INPUT_BODY_UP) {
+        player.moveBodyUp();
+    } else if (input & PLAYER_INPUT_BODY_DOWN) {
+        player.moveBodyDown();
+    }
+
+    if (input & PLAYER_INPUT_JUMP) {
+        player.triggerJump();
+    }
+}
+
+bool writeInputLog(const std::string& path, const InputLog& log) {
+    std::ofstream out(path.c_str(), std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    out.write(MAGIC, 4);
+    putU32(out, VERSION);
+    putU32(out, log.seed);
+    uint32_t tickRateBits;
+    std::memcpy(&tickRateBits, &log.tickRate, sizeof(tickRateBits));
+    putU32(out, tickRateBits);
+    putU64(out, log.ticks.size());
+
+    size_t i = 0;
+    while (i < log.ticks.size()) {
+        const uint8_t mask = log.ticks[i];
+        size_t run = 1;
+        while (i + run < log.ticks.size() && log.ticks[i + run] == mask && run < UINT32_MAX) {
+            ++run;
+        }
+        out.put(static_cast<char>(mask));
+        putU32(out, static_cast<uint32_t>(run));
+        i += run;
+    }
+    return static_cast<bool>(out);
+}
+
+bool readInputLog(const std::string& path, InputLog& log) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    char magic[4];
+    if (!in || !in.read(magic, 4) || std::memcmp(magic, MAGIC, 4) != 0) {
+        return false;
+    }
+    uint32_t version = 0, tickRateBits = 0;
+    uint64_t tickCount = 0;
+    if (!getU32(in, version) || version != VERSION || !getU32(in, log.seed) ||
+        !getU32(in, tickRateBits) || !getU64(in, tickCount)) {
+        return false;
+    }
+    // A rate of 0 or NaN would make every replayed tick NaN, and a headless run counts ticks in an int
+    std::memcpy(&log.tickRate, &tickRateBits, sizeof(tickRateBits));
+    if (!std::isfinite(log.tickRate) || log.tickRate <= 0.0f || tickCount > static_cast<uint64_t>(INT_MAX)) {
+        return false;
+    }
+
+    log.ticks.clear();
+    while (log.ticks.size() < tickCount) {
+        char mask;
+        uint32_t run = 0;
+        if (!in.get(mask) || !getU32(in, run) || run == 0 || run > tickCount - log.ticks.size()) {
+            return false;
+        }
+        log.ticks.insert(log.ticks.end(), run, static_cast<uint8_t>(mask));
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+// Description: Source file for SpatialGrid.
+#include "sim/SpatialGrid.h"
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : cellSize_(cellSize), inverseCellSize_(1.0f / cellSize), count_(0) {
+}
+
+void SpatialGrid::clear() {
+    entries_.clear();
+    cells_.clear();
+    count_ = 0;
+}
+
+size_t SpatialGrid::size() const {
+    return count_;
+}
+
+uint64_t SpatialGrid::cellKey(int cx, int cz) const {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cz);
+}
+
+int SpatialGrid::cellCoord(float value) const {
+    return static_cast<int>(std::floor(value * inverseCellSize_));
+}
+
+void SpatialGrid::link(uint32_t id, uint64_t cell) {
+    std::vector<uint32_t>& bucket = cells_[cell];
+    entries_[id].cell = cell;
+    entries_[id].slot = static_cast<uint32_t>(bucket.size());
+    bucket.push_back(id);
+}
+
+void SpatialGrid::unlink(uint32_t id) {
+    std::vector<uint32_t>& bucket = cells_[entries_[id].cell];
+    uint32_t slot = entries_[id].slot;
+    uint32_t moved = bucket.back();
+    bucket[slot] = moved;
+    entries_[moved].slot = slot;
+    bucket.pop_back();
+}
+
+void SpatialGrid::insert(uint32_t id, float x, float z) {
+    if (id >= entries_.size()) {
+        entries_.resize(id + 1);
+        entries_[id].present = false;
+    }
+    if (entries_[id].present) {
+        update(id, x, z);
+        return;
+    }
+    Entry& entry = entries_[id];
+    entry.x = x;
+    entry.z = z;
+    entry.present = true;
+    link(id, cellKey(cellCoord(x), cellCoord(z)));
+    ++count_;
+}
+
+void SpatialGrid::update(uint32_t id, float x, float z) {
+    Entry& entry = entries_[id];
+    entry.x = x;
+    entry.z = z;
+    uint64_t cell = cellKey(cellCoord(x), cellCoord(z));
+    if (cell != entry.cell) {
+        unlink(id);
+        link(id, cell);
+    }
+}
+
+void SpatialGrid::remove(uint32_t id) {
+    if (id >= entries_.size() || !entries_[id].present) {
+        return;
+    }
+    unlink(id);
+    entries_[id].present = false;
+    --count_;
+}
+
+void SpatialGrid::relabel(uint32_t from, uint32_t to) {
+    if (from == to || from >= entries_.size() || !entries_[from].present) {
+        return;
+    }
+    remove(to);
+    if (to >= entries_.size()) {
+        entries_.resize(to + 1);
+    }
+    entries_[to] = entries_[from];
+    cells_[entries_[to].cell][entries_[to].slot] = to;
+    entries_[from].present = false;
+}
+
+void SpatialGrid::queryRadius(float x, float z, float radius, std::vector<uint32_t>& result) const {
+    const int minX = cellCoord(x - radius), maxX = cellCoord(x + radius);
+    const int minZ = cellCoord(z - radius), maxZ = cellCoord(z + radius);
+    const float radiusSq = radius * radius;
+
+    for (int cx = minX; cx <= maxX; ++cx) {
+        for (int cz = minZ; cz <= maxZ; ++cz) {
+            auto it = cells_.find(cellKey(cx, cz));
+            if (it == cells_.end()) {
+                continue;
+            }
+            for (uint32_t id : it->second) {
+                float dx = entries_[id].x - x;
+                float dz = entries_[id].z - z;
+                if (dx * dx + dz * dz < radiusSq) {
+                    result.push_back(id);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,308 @@
+// Description: Source file for SpiderPopulation and its systems.
+#include "sim/SpiderPopulation.h"
+#include "spider/Cephalothorax.h"
+#include "spider/LegIKBatch.h"
+#include "spider/LegIKCache.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    const size_t ANGLES_PER_SPIDER = LEG_COUNT * LEG_SEGMENT_COUNT;
+
+    // Seconds between the steering patterns of consecutively spawned spiders
+    const float STEER_PHASE_STEP = 1.8f;
+
+    template <typename T>
+    void swapRemove(std::vector<T>& values, size_t index, size_t stride = 1) {
+        size_t last = values.size() / stride - 1;
+        if (index != last) {
+            std::copy(values.begin() + last * stride, values.begin() + (last + 1) * stride,
+                      values.begin() + index * stride);
+        }
+        values.resize(last * stride);
+    }
+}
+
+SpiderPopulation::SpiderPopulation() {
+    std::fill(legIKMethods, legIKMethods + LEG_COUNT, spider::LegIKMethod::CCD);
+}
+
+size_t SpiderPopulation::size() const {
+    return positionX.size();
+}
+
+bool SpiderPopulation::empty() const {
+    return positionX.empty();
+}
+
+void SpiderPopulation::reserve(size_t count) {
+    positionX.reserve(count);
+    positionY.reserve(count);
+    positionZ.reserve(count);
+    yaw.reserve(count);
+    scale.reserve(count);
+    locomotion.reserve(count);
+    steerPhase.reserve(count);
+    legAnimationCycle.reserve(count);
+    abdomenShakeCycle.reserve(count);
+    jointAngles.reserve(count * ANGLES_PER_SPIDER);
+    ikSolvedHeight.reserve(count);
+}
+
+void SpiderPopulation::clear() {
+    positionX.clear();
+    positionY.clear();
+    positionZ.clear();
+    yaw.clear();
+    scale.clear();
+    locomotion.clear();
+    steerPhase.clear();
+    legAnimationCycle.clear();
+    abdomenShakeCycle.clear();
+    jointAngles.clear();
+    ikSolvedHeight.clear();
+}
+
+size_t SpiderPopulation::spawn(const vec3& position, float spiderScale) {
+    steerPhase.push_back(size() * STEER_PHASE_STEP);
+    positionX.push_back(position.x);
+    positionY.push_back(position.y);
+    positionZ.push_back(position.z);
+    yaw.push_back(0.0f);
+    scale.push_back(spiderScale);
+    locomotion.push_back(0);
+    legAnimationCycle.push_back(0.0f);
+    abdomenShakeCycle.push_back(0.0f);
+    for (int leg = 0; leg < LEG_COUNT; ++leg) {
+        jointAngles.insert(jointAngles.end(), LEG_REST_JOINT_ANGLES, LEG_REST_JOINT_ANGLES + LEG_SEGMENT_COUNT);
+    }
+    ikSolvedHeight.push_back(std::numeric_limits<float>::quiet_NaN());
+    return size() - 1;
+}
+
+void SpiderPopulation::remove(size_t index) {
+    swapRemove(positionX, index);
+    swapRemove(positionY, index);
+    swapRemove(positionZ, index);
+    swapRemove(yaw, index);
+    swapRemove(scale, index);
+    swapRemove(locomotion, index);
+    swapRemove(steerPhase, index);
+    swapRemove(legAnimationCycle, index);
+    swapRemove(abdomenShakeCycle, index);
+    swapRemove(jointAngles, index, ANGLES_PER_SPIDER);
+    swapRemove(ikSolvedHeight, index);
+}
+
+void SpiderPopulation::setLegIKMethod(int leg, spider::LegIKMethod method) {
+    if (leg < 0 || leg >= LEG_COUNT || legIKMethods[leg] == method) {
+        return;
+    }
+    legIKMethods[leg] = method;
+    invalidateIK();
+}
+
+void SpiderPopulation::invalidateIK() {
+    std::fill(ikSolvedHeight.begin(), ikSolvedHeight.end(), std::numeric_limits<float>::quiet_NaN());
+}
+
+vec3 SpiderPopulation::getPosition(size_t index) const {
+    return vec3(positionX[index], positionY[index], positionZ[index]);
+}
+
+float* SpiderPopulation::jointAnglesOf(size_t index) {
+    return &jointAngles[index * ANGLES_PER_SPIDER];
+}
+
+const float* SpiderPopulation::jointAnglesOf(size_t index) const {
+    return &jointAngles[index * ANGLES_PER_SPIDER];
+}
+
+spider::SpiderState SpiderPopulation::stateAt(size_t index) const {
+    spider::SpiderState state;
+    state.position = getPosition(index);
+    float yawRad = yaw[index] * static_cast<float>(M_PI) / 180.0f;
+    state.forward = vec3(std::sin(yawRad), 0.0f, std::cos(yawRad));
+    state.yaw = yaw[index];
+    state.scale = scale[index];
+
+    uint8_t flags = locomotion[index];
+    state.walkingForward = (flags & LOCOMOTION_WALK_FORWARD) != 0;
+    state.walkingBackward = (flags & LOCOMOTION_WALK_BACKWARD) != 0;
+    state.turningLeft = (flags & LOCOMOTION_TURN_LEFT) != 0;
+    state.turningRight = (flags & LOCOMOTION_TURN_RIGHT) != 0;
+
+    state.legAnimationCycle = legAnimationCycle[index];
+    state.abdomenShakeCycle = abdomenShakeCycle[index];
+
+    state.jumpTriggered = false;
+    state.jumping = false;
+    state.jumpTime = 0.0f;
+
+    std::copy(jointAnglesOf(index), jointAnglesOf(index) + ANGLES_PER_SPIDER, &state.jointAngles[0][0]);
+    return state;
+}
+
+void steerSystem(SpiderPopulation& population, float time, size_t begin, size_t end) {
+    uint8_t* flags = population.locomotion.data();
+    const float* phase = population.steerPhase.data();
+    for (size_t i = begin; i < end; ++i) {
+        float t = time + phase[i];
+        uint8_t turn = (std::fmod(t, 4.0f) < 2.0f) ? LOCOMOTION_TURN_LEFT : LOCOMOTION_TURN_RIGHT;
+        flags[i] = LOCOMOTION_WALK_FORWARD | turn;
+    }
+}
+
+void locomotionSystem(SpiderPopulation& population, float deltaTime, size_t begin, size_t end) {
+    const uint8_t* flags = population.locomotion.data();
+    float* yaw = population.yaw.data();
+    float* px = population.positionX.data();
+    float* pz = population.positionZ.data();
+    const float degToRad = static_cast<float>(M_PI) / 180.0f;
+
+    for (size_t i = begin; i < end; ++i) {
+        float turn = ((flags[i] & LOCOMOTION_TURN_LEFT) ? 1.0f : 0.0f)
+                   - ((flags[i] & LOCOMOTION_TURN_RIGHT) ? 1.0f : 0.0f);
+        float walk = (flags[i] & LOCOMOTION_WALK_FORWARD) ? 1.0f
+                   : ((flags[i] & LOCOMOTION_WALK_BACKWARD) ? -1.0f : 0.0f);
+
+        float y = yaw[i] + turn * SPIDER_TURN_SPEED * deltaTime;
+        y = std::fmod(std::fmod(y, 360.0f) + 360.0f, 360.0f);
+        yaw[i] = y;
+
+        // The forward vector is (sin, 0, cos) and already unit length
+        float step = walk * SPIDER_WALK_SPEED * deltaTime;
+        px[i] += std::sin(y * degToRad) * step;
+        pz[i] += std::cos(y * degToRad) * step;
+    }
+}
+
+void gaitSystem(SpiderPopulation& population, float deltaTime, size_t begin, size_t end) {
+    const uint8_t* flags = population.locomotion.data();
+    float* legCycle = population.legAnimationCycle.data();
+    float* shakeCycle = population.abdomenShakeCycle.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        if (flags[i] == 0) {
+            continue;
+        }
+        float leg = legCycle[i] + LEG_ANIMATION_SPEED * deltaTime;
+        legCycle[i] = (leg > 1.0f) ? leg - 2.0f : leg;
+
+        float shake = shakeCycle[i] + ABDOMEN_SHAKE_SPEED * deltaTime;
+        shakeCycle[i] = (shake > 1.0f) ? shake - 1.0f : shake;
+    }
+}
+
+void legIKSystem(SpiderPopulation& population, size_t begin, size_t end) {
+    if (begin >= end) {
+        return;
+    }
+    const std::array<vec3, LEG_COUNT>& attachPoints = spider::Cephalothorax::getRig().legAttachments;
+    const size_t legCount = attachPoints.size();
+
+    // The targets only depend on body height, so spiders on flat ground keep their pose.
+    // NaN never compares equal, which sends fresh and invalidated spiders through.
+    std::vector<size_t> dirty;
+    for (size_t i = begin; i < end; ++i) {
+        if (population.ikSolvedHeight[i] != population.positionY[i]) {
+            dirty.push_back(i);
+        }
+    }
+    spider::recordLegIKSolves(dirty.size() * legCount, (end - begin - dirty.size()) * legCount);
+    if (dirty.empty()) {
+        return;
+    }
+
+    spider::LegIKProblem problem;
+    problem.targetX = LEG_IK_TARGET_REACH;
+    problem.segmentLength = LEG_SEGMENT_LENGTH;
+    problem.segmentCount = LEG_SEGMENT_COUNT;
+    problem.maxIter = LEG_IK_MAX_ITERATIONS;
+    problem.tolerance = LEG_IK_TOLERANCE;
+    problem.thetaMin = LEG_JOINT_MIN_ANGLES;
+    problem.thetaMax = LEG_JOINT_MAX_ANGLES;
+    problem.restPose = LEG_IK_FOLDED_POSE;
+
+    // With the shared cache every solve is a table lookup (after startup precompute)
+    spider::LegIKCache& cache = spider::LegIKCache::instance();
+    if (cache.isEnabled()) {
+        for (size_t i : dirty) {
+            float* angles = population.jointAnglesOf(i);
+            for (size_t leg = 0; leg < legCount; ++leg) {
+                problem.targetY = attachPoints[leg].y - population.positionY[i];
+                cache.solve(population.legIKMethods[leg], problem, angles + leg * LEG_SEGMENT_COUNT);
+            }
+            population.ikSolvedHeight[i] = population.positionY[i];
+        }
+        return;
+    }
+
+    // CCD legs of every dirty spider go into one batch, so the SIMD lanes stay full;
+    // legs set to another method are solved one at a time. Both start from the current pose.
+    std::vector<size_t> batchedLegs;
+    for (size_t leg = 0; leg < legCount; ++leg) {
+        if (population.legIKMethods[leg] == spider::LegIKMethod::CCD) {
+            batchedLegs.push_back(leg);
+        }
+    }
+
+    if (!batchedLegs.empty()) {
+        const size_t batchLegs = dirty.size() * batchedLegs.size();
+        std::vector<float> targetX(batchLegs, LEG_IK_TARGET_REACH), targetY(batchLegs);
+        std::vector<float> solved(batchLegs * LEG_SEGMENT_COUNT);
+        size_t slot = 0;
+        for (size_t i : dirty) {
+            const float* angles = population.jointAnglesOf(i);
+            for (size_t leg : batchedLegs) {
+                targetY[slot] = attachPoints[leg].y - population.positionY[i];
+                std::copy(angles + leg * LEG_SEGMENT_COUNT, angles + (leg + 1) * LEG_SEGMENT_COUNT,
+                          &solved[slot * LEG_SEGMENT_COUNT]);
+                ++slot;
+            }
+        }
+
+        spider::LegIKBatch batch;
+        batch.legCount = batchLegs;
+        batch.segmentCount = LEG_SEGMENT_COUNT;
+        batch.segmentLength = LEG_SEGMENT_LENGTH;
+        batch.maxIter = LEG_IK_MAX_ITERATIONS;
+        batch.tolerance = LEG_IK_TOLERANCE;
+        batch.targetX = targetX.data();
+        batch.targetY = targetY.data();
+        batch.thetaMin = LEG_JOINT_MIN_ANGLES;
+        batch.thetaMax = LEG_JOINT_MAX_ANGLES;
+        batch.limitStride = 0;
+        batch.thetaStart = solved.data();
+        batch.thetaOut = solved.data();
+        spider::solveLegIKBatch(batch);
+
+        slot = 0;
+        for (size_t i : dirty) {
+            float* angles = population.jointAnglesOf(i);
+            for (size_t leg : batchedLegs) {
+                const float* first = &solved[slot++ * LEG_SEGMENT_COUNT];
+                std::copy(first, first + LEG_SEGMENT_COUNT, angles + leg * LEG_SEGMENT_COUNT);
+            }
+        }
+    }
+
+    if (batchedLegs.size() != legCount) {
+        for (size_t i : dirty) {
+            float* angles = population.jointAnglesOf(i);
+            for (size_t leg = 0; leg < legCount; ++leg) {
+                const spider::LegIKMethod method = population.legIKMethods[leg];
+                if (method == spider::LegIKMethod::CCD) {
+                    continue;
+                }
+                problem.targetY = attachPoints[leg].y - population.positionY[i];
+                spider::getLegIKSolver(method).solve(problem, angles + leg * LEG_SEGMENT_COUNT);
+            }
+        }
+    }
+
+    for (size_t i : dirty) {
+        population.ikSolvedHeight[i] = population.positionY[i];
+    }
+}
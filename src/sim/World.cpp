@@ -0,0 +1,239 @@
+// Description: Source file for the World class, implementing the AI steering and collision rules.
+#include "sim/World.h"
+#include "spider/Cephalothorax.h"
+#include "spider/LegIKCache.h"
+#include "utils/JobSystem.h"
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <string>
+
+namespace {
+    // Spiders per job; small enough to balance, large enough to amortise scheduling
+    const size_t AI_GRAIN_SIZE = 64;
+    const size_t AI_IK_GRAIN_SIZE = 16;
+
+    const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+    }
+
+    void hashFloats(uint64_t& hash, const std::vector<float>& values) {
+        if (!values.empty()) {
+            hashBytes(hash, values.data(), values.size() * sizeof(float));
+        }
+    }
+}
+
+World::World()
+    : score(0) {
+}
+
+void World::precomputeLegIK() {
+    spider::LegIKCache& cache = spider::LegIKCache::instance();
+    if (!cache.isEnabled()) {
+        return;
+    }
+
+    spider::LegIKProblem problem;
+    problem.targetX = LEG_IK_TARGET_REACH;
+    problem.segmentLength = LEG_SEGMENT_LENGTH;
+    problem.segmentCount = LEG_SEGMENT_COUNT;
+    problem.maxIter = LEG_IK_MAX_ITERATIONS;
+    problem.tolerance = LEG_IK_TOLERANCE;
+    problem.thetaMin = LEG_JOINT_MIN_ANGLES;
+    problem.thetaMax = LEG_JOINT_MAX_ANGLES;
+    problem.restPose = LEG_IK_FOLDED_POSE;
+
+    // Target height is attachment height minus body height, so each leg covers its own band
+    const std::array<vec3, LEG_COUNT>& attachPoints = spider::Cephalothorax::getRig().legAttachments;
+    const size_t legCount = attachPoints.size();
+    for (size_t leg = 0; leg < legCount; ++leg) {
+        const float lowest = attachPoints[leg].y - BODY_MAX_Y;
+        const float highest = attachPoints[leg].y - BODY_MIN_Y;
+        cache.precompute(aiSpiders.legIKMethods[leg], problem, lowest, highest);
+        if (player.getLegIKMethod(static_cast<int>(leg)) != aiSpiders.legIKMethods[leg]) {
+            cache.precompute(player.getLegIKMethod(static_cast<int>(leg)), problem, lowest, highest);
+        }
+    }
+}
+
+void World::initAISpiders(int count) {
+    // Önceki AI örümcekleri temizle
+    aiSpiders.clear();
+    aiSpiderGrid.clear();
+
+    // Yeni AI örümcekler oluştur
+    aiSpiders.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        float x = (rand() % 400 - 200) / 10.0f;
+        float z = (rand() % 400 - 200) / 10.0f;
+
+        size_t index = aiSpiders.spawn(vec3(x, 0.7f, z), 0.25f); // Make AI spiders smaller
+        aiSpiderGrid.insert(static_cast<uint32_t>(index), x, z);
+    }
+}
+
+void World::setupObstacles(GLuint shaderProgram, int count) {
+    obstacles.reserve(obstacles.size() + count);
+    for (int i = 0; i < count; ++i) {
+        float x = static_cast<float>((rand() % 400 - 200) / 10.0f); // -20.0f to +20.0f
+        float z = static_cast<float>((rand() % 400 - 200) / 10.0f);
+        int type = rand() % 4;
+        int pointValue;
+        std::string modelPath;
+        switch (type) {
+            case 0: // Kale
+                pointValue = 5;
+                modelPath = "models/rook.stl";
+                break;
+            case 1: // Vezir
+                pointValue = 3;
+                modelPath = "models/queen.stl";
+                break;
+            case 2: // Piyon
+                pointValue = 1;
+                modelPath = "models/pawn.stl";
+                break;
+            case 3: // Engelleyici taş
+            default:
+                pointValue = -2;
+                modelPath = "models/blocker.stl";
+                break;
+        }
+        obstacleGrid.insert(static_cast<uint32_t>(obstacles.size()), x, z);
+        obstacles.emplace_back(vec3(x, 0.5f, z), 1.0f, pointValue, shaderProgram, modelPath);
+    }
+}
+
+void World::updateAISpiders(float time, float deltaTime) {
+    const size_t count = aiSpiders.size();
+    steerSystem(aiSpiders, time, 0, count);
+    locomotionSystem(aiSpiders, deltaTime, 0, count);
+    gaitSystem(aiSpiders, deltaTime, 0, count);
+    updateAISpatialIndex();
+    legIKSystem(aiSpiders, 0, count);
+}
+
+void World::updateAILocomotion(JobSystem& jobs, float time, float deltaTime) {
+    jobs.parallelFor(aiSpiders.size(), AI_GRAIN_SIZE, [this, time, deltaTime](size_t begin, size_t end) {
+        steerSystem(aiSpiders, time, begin, end);
+        locomotionSystem(aiSpiders, deltaTime, begin, end);
+        gaitSystem(aiSpiders, deltaTime, begin, end);
+    });
+}
+
+void World::solveAILegIK(JobSystem& jobs) {
+    jobs.parallelFor(aiSpiders.size(), AI_IK_GRAIN_SIZE, [this](size_t begin, size_t end) {
+        legIKSystem(aiSpiders, begin, end);
+    });
+}
+
+void World::updateAISpatialIndex() {
+    const size_t count = aiSpiders.size();
+    for (size_t i = 0; i < count; ++i) {
+        aiSpiderGrid.update(static_cast<uint32_t>(i), aiSpiders.positionX[i], aiSpiders.positionZ[i]);
+    }
+}
+
+void World::removeAISpider(size_t index) {
+    uint32_t last = static_cast<uint32_t>(aiSpiders.size() - 1);
+    aiSpiderGrid.remove(static_cast<uint32_t>(index));
+    aiSpiderGrid.relabel(last, static_cast<uint32_t>(index));
+    aiSpiders.remove(index);
+}
+
+void World::removeObstacle(size_t index) {
+    uint32_t last = static_cast<uint32_t>(obstacles.size() - 1);
+    obstacleGrid.remove(static_cast<uint32_t>(index));
+    obstacleGrid.relabel(last, static_cast<uint32_t>(index));
+    if (index != last) {
+        obstacles[index] = std::move(obstacles[last]);
+    }
+    obstacles.pop_back();
+}
+
+CollisionEvents World::checkCollisions() {
+    CollisionEvents events;
+    vec3 spiderPosCollision = player.getPosition();
+    std::vector<uint32_t> candidates;
+
+    // Check collision with obstacles
+    const float obstacleRadius = 1.0f; // Adjust collision threshold if needed
+    obstacleGrid.queryRadius(spiderPosCollision.x, spiderPosCollision.z, obstacleRadius, candidates);
+    // Highest index first, so swap-and-pop never moves a pending hit
+    std::sort(candidates.begin(), candidates.end(), std::greater<uint32_t>());
+    for (uint32_t index : candidates) {
+        vec3 diff = spiderPosCollision - obstacles[index].getPosition();
+        if (dot(diff, diff) < obstacleRadius * obstacleRadius) {
+            score += obstacles[index].getPointValue();
+            ++events.obstaclesHit;
+            std::cout << "Collision with obstacle! Score: " << score << std::endl;
+
+            removeObstacle(index); // Remove obstacle after collision
+        }
+    }
+
+    // Check collision with AI spiders
+    const float spiderRadius = 1.5f; // Slightly larger threshold for spiders
+    candidates.clear();
+    aiSpiderGrid.queryRadius(spiderPosCollision.x, spiderPosCollision.z, spiderRadius, candidates);
+    std::sort(candidates.begin(), candidates.end(), std::greater<uint32_t>());
+    for (uint32_t index : candidates) {
+        vec3 diff = spiderPosCollision - aiSpiders.getPosition(index);
+        if (dot(diff, diff) < spiderRadius * spiderRadius) {
+            score += 10; // Add points for eating a spider
+            ++events.spidersEaten;
+            std::cout << "Spider eaten! Score: " << score << std::endl;
+
+            removeAISpider(index); // Remove the eaten spider
+
+            // Increase player spider's size when it eats an AI spider
+            float currentScale = player.getScale();
+            player.setScale(currentScale + 0.1f); // Grow by 5% each time
+            std::cout << "Spider grew! New scale: " << player.getScale() << std::endl;
+        }
+    }
+
+    // If all spiders are eaten, spawn new ones
+    if (aiSpiders.empty()) {
+        initAISpiders();
+    }
+
+    return events;
+}
+
+uint64_t World::stateHash() const {
+    uint64_t hash = FNV_OFFSET;
+
+    // Field by field: SpiderState has padding after its flags
+    const spider::SpiderState& p = player.getState();
+    hashBytes(hash, &p.position, sizeof(p.position));
+    hashBytes(hash, &p.yaw, sizeof(p.yaw));
+    hashBytes(hash, &p.scale, sizeof(p.scale));
+    hashBytes(hash, &p.legAnimationCycle, sizeof(p.legAnimationCycle));
+    hashBytes(hash, &p.jumpTime, sizeof(p.jumpTime));
+    hashBytes(hash, p.jointAngles, sizeof(p.jointAngles));
+
+    hashFloats(hash, aiSpiders.positionX);
+    hashFloats(hash, aiSpiders.positionY);
+    hashFloats(hash, aiSpiders.positionZ);
+    hashFloats(hash, aiSpiders.yaw);
+    hashFloats(hash, aiSpiders.legAnimationCycle);
+    hashFloats(hash, aiSpiders.jointAngles);
+
+    for (const Obstacle& obstacle : obstacles) {
+        hashBytes(hash, &obstacle.getPosition(), sizeof(vec3));
+    }
+    hashBytes(hash, &score, sizeof(score));
+    return hash;
+}
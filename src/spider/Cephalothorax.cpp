@@ -1,7 +1,10 @@
 // Cephalothorax.cpp
 #include "spider/Cephalothorax.h"
+#include "utils/DrawStats.h"
+#include "spider/Head.h"
 #include "global/GlobalConfig.h"
-#include "utils/PerlinNoise.h"
+#include "spider/EllipsoidMesh.h"
+#include "utils/Profiler.h"
 #include <iostream>
 #include <vector>
 #include <cmath>
@@ -10,41 +13,50 @@
 
 namespace spider {
 
-Cephalothorax::Cephalothorax(GLuint shaderProgram)
-    : _program(shaderProgram), _vao(0), _vbo(0), _ebo(0), _indexCount(0) {
-    initMesh();
-}
-
-Cephalothorax::~Cephalothorax() {
-    cleanup();
+namespace {
+    constexpr int DEFAULT_STACKS = 30;
+    constexpr int DEFAULT_SLICES = 30;
+
+    // Undisplaced ellipsoid surface, the positions generateVertexData starts from before adding noise
+    std::vector<vec3> generateRestPositions(int stacks, int slices,
+                                            float radiusX, float radiusY, float radiusZ) {
+        std::vector<vec3> positions;
+        positions.reserve((stacks + 1) * (slices + 1));
+        for (int i = 0; i <= stacks; ++i) {
+            float v = M_PI * i / stacks;
+            float sinV = std::sin(v), cosV = std::cos(v);
+            for (int j = 0; j <= slices; ++j) {
+                float u = 2.0f * M_PI * j / slices;
+                positions.emplace_back(radiusX * sinV * std::cos(u),
+                                       radiusY * sinV * std::sin(u),
+                                       radiusZ * cosV);
+            }
+        }
+        return positions;
+    }
 }
 
-void Cephalothorax::cleanup() {
-    if (_vao != 0) {
-        glDeleteVertexArrays(1, &_vao);
-        glDeleteBuffers(1, &_vbo);
-        glDeleteBuffers(1, &_ebo);
-        _vao = _vbo = _ebo = 0;
-    }
+Cephalothorax::Cephalothorax(GLuint shaderProgram)
+    : _program(shaderProgram) {
+    initMesh();
 }
 
 void Cephalothorax::initMesh() {
-    const int stacks = 30;
-    const int slices = 30;
-
     const float baseRadius = ABDOMEN_RADIUS *0.8f;
     const float radiusX = baseRadius * ABDOMEN_SCALE_X*0.7F;
     const float radiusY = baseRadius * ABDOMEN_SCALE_X * 0.7F;
     const float radiusZ = baseRadius * ABDOMEN_SCALE_Z * 1.1F;
 
-    std::vector<GLfloat> interleavedData;
-    std::vector<GLuint> indices;
-    _vertexPositions.clear();
-    _vertexPositionsNormal.clear();
-
-    generateVertexData(stacks, slices, radiusX, radiusY, radiusZ, interleavedData);
-    generateIndices(stacks, slices, indices);
-    uploadToGPU(interleavedData, indices);
+    for (int lod = 0; lod < MESH_LOD_COUNT; ++lod) {
+        const int stacks = MESH_LOD_TESSELLATION[lod];
+        const int slices = MESH_LOD_TESSELLATION[lod];
+        const MeshKey key = {MeshPart::Cephalothorax, stacks, slices, radiusX, radiusY, radiusZ,
+                             NOISE_SCALE, NOISE_STRENGHT * ABDOMEN_RADIUS};
+        _meshes[lod] = MeshRegistry::instance().acquire(key, [&](MeshData& data) {
+            generateVertexData(stacks, slices, radiusX, radiusY, radiusZ, data.vertices);
+            generateIndices(stacks, slices, data.indices);
+        });
+    }
 }
 
 void Cephalothorax::generateVertexData(
@@ -52,44 +64,8 @@ void Cephalothorax::generateVertexData(
     float radiusX, float radiusY, float radiusZ,
     std::vector<GLfloat>& interleavedData
 ) {
-    PerlinNoise perlin;
-    float noiseScale = NOISE_SCALE;
-    float noiseStrength = NOISE_STRENGHT * ABDOMEN_RADIUS;
-
-    for (int i = 0; i <= stacks; ++i) {
-        float v = M_PI * i / stacks;
-        float sinV = std::sin(v), cosV = std::cos(v);
-
-        for (int j = 0; j <= slices; ++j) {
-            float u = 2.0f * M_PI * j / slices;
-            float sinU = std::sin(u), cosU = std::cos(u);
-
-            float x = radiusX * sinV * cosU;
-            float y = radiusY * sinV * sinU;
-            float z = radiusZ * cosV;
-
-            float nx = sinV * cosU / radiusX;
-            float ny = sinV * sinU / radiusY;
-            float nz = cosV / radiusZ;
-            vec3 normal = normalize(vec3(nx, ny, nz));
-
-            _vertexPositionsNormal.push_back(vec3(x, y, z));
-
-            float noiseValue = perlin.noise(x * noiseScale, y * noiseScale, z * noiseScale);
-            x += normal.x * noiseValue * noiseStrength;
-            y += normal.y * noiseValue * noiseStrength;
-            z += normal.z * noiseValue * noiseStrength;
-
-            _vertexPositions.emplace_back(x, y, z);
-
-            interleavedData.push_back(x);
-            interleavedData.push_back(y);
-            interleavedData.push_back(z);
-            interleavedData.push_back(normal.x);
-            interleavedData.push_back(normal.y);
-            interleavedData.push_back(normal.z);
-        }
-    }
+    generateNoisyEllipsoid(stacks, slices, radiusX, radiusY, radiusZ,
+                           NOISE_SCALE, NOISE_STRENGHT * ABDOMEN_RADIUS, interleavedData);
 }
 
 void Cephalothorax::generateIndices(
@@ -110,52 +86,59 @@ void Cephalothorax::generateIndices(
             indices.push_back(row1 + 1);
         }
     }
-
-    _indexCount = GLsizei(indices.size());
 }
 
-void Cephalothorax::uploadToGPU(
-    const std::vector<GLfloat>& interleavedData,
-    const std::vector<GLuint>& indices
-) {
-    cleanup();
-
-    glGenVertexArrays(1, &_vao);
-    glGenBuffers(1, &_vbo);
-    glGenBuffers(1, &_ebo);
-
-    glBindVertexArray(_vao);
+const std::array<vec3, LEG_COUNT>& Cephalothorax::getLegAttachmentPoints() const {
+    return getRig().legAttachments;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER,
-                 interleavedData.size() * sizeof(GLfloat),
-                 interleavedData.data(),
-                 GL_STATIC_DRAW);
+const vec3& Cephalothorax::getHeadAnchorPoint() const {
+    return getRig().headAnchor;
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 indices.size() * sizeof(GLuint),
-                 indices.data(),
-                 GL_STATIC_DRAW);
+const SpiderRig& Cephalothorax::getRig() {
+    // Everything in the rig only depends on the body constants, so it is computed once per process
+    static const SpiderRig rig = buildRig();
+    return rig;
+}
 
-    constexpr GLuint stride = 6 * sizeof(GLfloat);
+SpiderRig Cephalothorax::buildRig() {
+    PROFILE_SCOPE("Cephalothorax::buildRig");
+    const float baseRadius = ABDOMEN_RADIUS * 0.8f;
+    const std::vector<vec3> restPositions =
+        generateRestPositions(DEFAULT_STACKS, DEFAULT_SLICES,
+                              baseRadius * ABDOMEN_SCALE_X * 0.7f,
+                              baseRadius * ABDOMEN_SCALE_X * 0.7f,
+                              baseRadius * ABDOMEN_SCALE_Z * 1.1f);
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    SpiderRig result;
+    const std::vector<vec3> attachments = selectLegAttachmentPoints(restPositions);
+    std::copy(attachments.begin(), attachments.begin() + LEG_COUNT, result.legAttachments.begin());
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride,
-                         (void*)(3 * sizeof(GLfloat)));
+    result.headAnchor = vec3(0.0f, 0.0f, 0.0f);
+    float maxZ = -std::numeric_limits<float>::max();
+    for (const vec3& vertex : restPositions) {
+        if (vertex.z > maxZ) {
+            maxZ = vertex.z;
+            result.headAnchor = vertex;
+        }
+    }
 
-    glBindVertexArray(0);
-}
+    result.eyeAnchor = Head::getMostFrontVertex();
 
-const std::vector<vec3>& Cephalothorax::getVertexPositions() const {
-    std::cout << "Cephalothorax vertex positions: " << _vertexPositions.size() << std::endl;
-    return _vertexPositions;
+    // The abdomen hangs behind the body (pivot at 1.8 of its length); legs reach
+    // at most their full length past the attachment. 10% covers noise and tilt.
+    const float abdomenLength = ABDOMEN_RADIUS * ABDOMEN_SCALE_Z;
+    float reach = abdomenLength * 2.8f;
+    const float legLength = LEG_SEGMENT_COUNT * LEG_SEGMENT_LENGTH;
+    for (const vec3& attachment : result.legAttachments) {
+        reach = std::max(reach, length(attachment) + legLength);
+    }
+    result.boundingRadius = reach * 1.1f;
+    return result;
 }
 
-std::vector<vec3> Cephalothorax::getLegAttachmentPoints() const {
+std::vector<vec3> Cephalothorax::selectLegAttachmentPoints(const std::vector<vec3>& restPositions) {
     std::vector<vec3> attachmentPoints;
     attachmentPoints.reserve(8);
     const int points_per_side = 4;
@@ -164,7 +147,7 @@ std::vector<vec3> Cephalothorax::getLegAttachmentPoints() const {
     const float cephRadiusX = cephBaseRadius * ABDOMEN_SCALE_X * 0.7f;
     const float cephRadiusZ = cephBaseRadius * ABDOMEN_SCALE_Z * 1.1f;
 
-    if (_vertexPositionsNormal.empty()) {
+    if (restPositions.empty()) {
         float default_side_x = cephRadiusX * 0.85f;
         float z_attach_min = -cephRadiusZ * 0.8f;
         float z_attach_max =  cephRadiusZ * 0.8f;
@@ -180,7 +163,7 @@ std::vector<vec3> Cephalothorax::getLegAttachmentPoints() const {
 
     float minX_actual = std::numeric_limits<float>::max();
     float maxX_actual = -std::numeric_limits<float>::max();
-    for (const vec3& vertex : _vertexPositionsNormal) {
+    for (const vec3& vertex : restPositions) {
         if (vertex.x < minX_actual) minX_actual = vertex.x;
         if (vertex.x > maxX_actual) maxX_actual = vertex.x;
     }
@@ -201,7 +184,7 @@ std::vector<vec3> Cephalothorax::getLegAttachmentPoints() const {
 
     const float filter_z_abs_limit = 0.9f * (ABDOMEN_RADIUS * ABDOMEN_SCALE_Z);
 
-    for (const vec3& vertex : _vertexPositionsNormal) {
+    for (const vec3& vertex : restPositions) {
         if (std::abs(vertex.z) > filter_z_abs_limit) {
             continue;
         }
@@ -288,29 +271,18 @@ std::vector<vec3> Cephalothorax::getLegAttachmentPoints() const {
     return attachmentPoints;
 }
 
-vec3 Cephalothorax::getHeadAnchorPoint() const {
-    vec3 headPoint(0.0f, 0.0f, 0.0f);
-    float maxZ = -std::numeric_limits<float>::max();
-
-    for (const vec3& vertex : _vertexPositionsNormal) {
-        if (vertex.z > maxZ) {
-            maxZ = vertex.z;
-            headPoint = vertex;
-        }
-    }
-
-    return headPoint;
-}
-
-void Cephalothorax::draw(GLuint modelViewLoc, GLuint projectionLoc,
-                         const mat4& modelMatrix, const mat4& P) const {
+void Cephalothorax::draw(GLuint modelLoc, const mat4& modelMatrix) const {
     glUseProgram(_program);
-    glUniformMatrix4fv(modelViewLoc, 1, GL_TRUE, modelMatrix);
-    glUniformMatrix4fv(projectionLoc, 1, GL_TRUE, P);
+    glUniformMatrix4fv(modelLoc, 1, GL_TRUE, modelMatrix);
 
-    glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, _indexCount, GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(_meshes[0]->vao.get());
+    glDrawElements(GL_TRIANGLES, _meshes[0]->indexCount, GL_UNSIGNED_INT, nullptr);
+    recordDrawCall(1, _meshes[0]->indexCount / 3);
     glBindVertexArray(0);
 }
 
+const MeshHandle& Cephalothorax::getMesh(int lod) const {
+    return _meshes[lod];
+}
+
 } // namespace spider
\ No newline at end of file
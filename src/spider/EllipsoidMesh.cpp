@@ -0,0 +1,81 @@
+// Description: Source file for the noise-displaced ellipsoid mesh.
+#include "spider/EllipsoidMesh.h"
+#include "utils/PerlinNoise.h"
+#include <cmath>
+
+namespace spider {
+
+void generateNoisyEllipsoid(int stacks, int slices,
+                            float radiusX, float radiusY, float radiusZ,
+                            float frequency, float amplitude,
+                            std::vector<float>& interleaved) {
+    const size_t count = static_cast<size_t>(stacks + 1) * (slices + 1);
+    std::vector<float> px(count), py(count), pz(count);
+    std::vector<float> nx(count), ny(count), nz(count);
+    std::vector<float> sx(count), sy(count), sz(count);
+
+    size_t k = 0;
+    for (int i = 0; i <= stacks; ++i) {
+        float v = M_PI * i / stacks;
+        float sinV = std::sin(v), cosV = std::cos(v);
+
+        for (int j = 0; j <= slices; ++j, ++k) {
+            float u = 2.0f * M_PI * j / slices;
+            float sinU = std::sin(u), cosU = std::cos(u);
+
+            px[k] = radiusX * sinV * cosU;
+            py[k] = radiusY * sinV * sinU;
+            pz[k] = radiusZ * cosV;
+
+            // Undisplaced normal, the direction the noise pushes along
+            float gx = sinV * cosU / radiusX;
+            float gy = sinV * sinU / radiusY;
+            float gz = cosV / radiusZ;
+            float invLength = 1.0f / std::sqrt(gx * gx + gy * gy + gz * gz);
+            nx[k] = gx * invLength;
+            ny[k] = gy * invLength;
+            nz[k] = gz * invLength;
+
+            sx[k] = px[k] * frequency;
+            sy[k] = py[k] * frequency;
+            sz[k] = pz[k] * frequency;
+        }
+    }
+
+    static const PerlinNoise perlin;
+    std::vector<float> value(count), dx(count), dy(count), dz(count);
+    NoiseBatch batch;
+    batch.count = count;
+    batch.x = sx.data();
+    batch.y = sy.data();
+    batch.z = sz.data();
+    batch.value = value.data();
+    batch.gradX = dx.data();
+    batch.gradY = dy.data();
+    batch.gradZ = dz.data();
+    perlin.evaluate(NoiseKind::Perlin, batch);
+
+    interleaved.reserve(interleaved.size() + count * 6);
+    for (k = 0; k < count; ++k) {
+        float offset = value[k] * amplitude;
+
+        // d(offset)/d(position); only its part along the surface bends the normal
+        float gx = dx[k] * frequency * amplitude;
+        float gy = dy[k] * frequency * amplitude;
+        float gz = dz[k] * frequency * amplitude;
+        float along = gx * nx[k] + gy * ny[k] + gz * nz[k];
+        float mx = nx[k] - (gx - along * nx[k]);
+        float my = ny[k] - (gy - along * ny[k]);
+        float mz = nz[k] - (gz - along * nz[k]);
+        float invLength = 1.0f / std::sqrt(mx * mx + my * my + mz * mz);
+
+        interleaved.push_back(px[k] + nx[k] * offset);
+        interleaved.push_back(py[k] + ny[k] * offset);
+        interleaved.push_back(pz[k] + nz[k] * offset);
+        interleaved.push_back(mx * invLength);
+        interleaved.push_back(my * invLength);
+        interleaved.push_back(mz * invLength);
+    }
+}
+
+} // namespace spider
@@ -1,10 +1,12 @@
 // Head.cpp
 #include "spider/Head.h"
+#include "utils/DrawStats.h"
 #include "global/GlobalConfig.h"
 #include <vector>
 #include <cmath>
-#include "utils/PerlinNoise.h"
+#include "spider/EllipsoidMesh.h"
 #include <algorithm>
+#include <limits>
 #include "spider/Eye.h"
 
 
@@ -21,32 +23,22 @@ Head::Head(GLuint shaderProgram)
 
 }
 
-Head::~Head() {
-    cleanup();
-}
-
-void Head::cleanup() {
-    if (_vao != 0) {
-        glDeleteVertexArrays(1, &_vao);
-        glDeleteBuffers(1, &_vbo);
-        glDeleteBuffers(1, &_ebo);
-        _vao = _vbo = _ebo = 0;
-    }
-}
-
 void Head::initMesh() {
-    _vertexPositions.clear();
-    std::vector<GLfloat> interleavedVertices;
-    std::vector<GLuint> indices;
-
     const float baseRadius = ABDOMEN_RADIUS * HEAD_SCALE;
     const float radiusX = baseRadius;
     const float radiusY = baseRadius;
     const float radiusZ = baseRadius * HEAD_SCALE_Z;
 
-    generateVertices(DEFAULT_STACKS, DEFAULT_SLICES, radiusX, radiusY, radiusZ, interleavedVertices);
-    generateIndices(DEFAULT_STACKS, DEFAULT_SLICES, indices);
-    uploadToGPU(interleavedVertices, indices);
+    for (int lod = 0; lod < MESH_LOD_COUNT; ++lod) {
+        const int stacks = MESH_LOD_TESSELLATION[lod];
+        const int slices = MESH_LOD_TESSELLATION[lod];
+        const MeshKey key = {MeshPart::Head, stacks, slices, radiusX, radiusY, radiusZ,
+                             NOISE_SCALE * 0.45f, NOISE_STRENGHT * ABDOMEN_RADIUS * 0.5f};
+        _meshes[lod] = MeshRegistry::instance().acquire(key, [&](MeshData& data) {
+            generateVertices(stacks, slices, radiusX, radiusY, radiusZ, data.vertices);
+            generateIndices(stacks, slices, data.indices);
+        });
+    }
 }
 
 
@@ -55,38 +47,9 @@ void Head::generateVertices(
     float radiusX, float radiusY, float radiusZ,
     std::vector<GLfloat>& interleavedVertices
 ) {
-    PerlinNoise perlin;
-    const float noiseFrequency = NOISE_SCALE * 0.45f;
-    const float noiseAmplitude = NOISE_STRENGHT * ABDOMEN_RADIUS * 0.5f;
-
-    for (int i = 0; i <= stacks; ++i) {
-        float v = M_PI * i / stacks;
-        float sinV = std::sin(v);
-        float cosV = std::cos(v);
-
-        for (int j = 0; j <= slices; ++j) {
-            float u = 2.0f * M_PI * j / slices;
-            float sinU = std::sin(u);
-            float cosU = std::cos(u);
-
-            float x = radiusX * sinV * cosU;
-            float y = radiusY * sinV * sinU;
-            float z = radiusZ * cosV;
-
-            // Calculate normal
-            vec3 normal = normalize(vec3(sinV * cosU / radiusX, sinV * sinU / radiusY, cosV / radiusZ));
-            _vertexPositionsEye.emplace_back(x, y, z);
-
-            // Apply noise displacement
-            float noiseValue = perlin.noise(x * noiseFrequency, y * noiseFrequency, z * noiseFrequency);
-            x += normal.x * noiseValue * noiseAmplitude;
-            y += normal.y * noiseValue * noiseAmplitude;
-            z += normal.z * noiseValue * noiseAmplitude;
-
-            _vertexPositions.emplace_back(x, y, z);
-            interleavedVertices.insert(interleavedVertices.end(), {x, y, z, normal.x, normal.y, normal.z});
-        }
-    }
+    // Broader, shallower bumps than the body
+    generateNoisyEllipsoid(stacks, slices, radiusX, radiusY, radiusZ,
+                           NOISE_SCALE * 0.45f, NOISE_STRENGHT * ABDOMEN_RADIUS * 0.5f, interleavedVertices);
 }
 
 void Head::generateIndices(
@@ -107,65 +70,49 @@ void Head::generateIndices(
             indices.push_back(row1 + 1);
         }
     }
-    _indexCount = static_cast<GLsizei>(indices.size());
 }
 
-    vec3 Head::getMostFrontVertex() const {
-    if (_vertexPositionsEye.empty()) {
-        return vec3(0.0f, 0.0f, 0.0f);
-    }
-
-    vec3 maxZVertex = _vertexPositionsEye[0];
-
-    for (const auto& vertex : _vertexPositionsEye) {
-        if (vertex.z > maxZVertex.z) {
-            maxZVertex = vertex;
+const vec3& Head::getMostFrontVertex() {
+    // Same parametrisation as generateVertices, before the noise displacement
+    static const vec3 frontVertex = [] {
+        const float baseRadius = ABDOMEN_RADIUS * HEAD_SCALE;
+        const float radiusX = baseRadius;
+        const float radiusY = baseRadius;
+        const float radiusZ = baseRadius * HEAD_SCALE_Z;
+
+        vec3 maxZVertex(0.0f, 0.0f, -std::numeric_limits<float>::max());
+        for (int i = 0; i <= DEFAULT_STACKS; ++i) {
+            float v = M_PI * i / DEFAULT_STACKS;
+            for (int j = 0; j <= DEFAULT_SLICES; ++j) {
+                float u = 2.0f * M_PI * j / DEFAULT_SLICES;
+                vec3 vertex(radiusX * std::sin(v) * std::cos(u),
+                            radiusY * std::sin(v) * std::sin(u),
+                            radiusZ * std::cos(v));
+                if (vertex.z > maxZVertex.z) {
+                    maxZVertex = vertex;
+                }
+            }
         }
-    }
-
-    return maxZVertex + vec3(0.001f, 0.001f, 0.001f);
-}
-
-void Head::uploadToGPU(
-    const std::vector<GLfloat>& interleavedVertices,
-    const std::vector<GLuint>& indices
-) {
-    cleanup(); // Ensure previous buffers are cleaned up
-
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-
-    glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, interleavedVertices.size() * sizeof(GLfloat), interleavedVertices.data(), GL_STATIC_DRAW);
-
-    glGenBuffers(1, &_ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-
-    constexpr GLuint stride = 6 * sizeof(GLfloat);
-    // Position attribute
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    // Normal attribute
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(GLfloat)));
-
-    glBindVertexArray(0);
+        return maxZVertex + vec3(0.001f, 0.001f, 0.001f);
+    }();
+    return frontVertex;
 }
 
-    void Head::draw(GLuint modelViewLoc, GLuint projectionLoc,
-                    const mat4& modelMatrix, const mat4& projMatrix) const {
+    void Head::draw(GLuint modelLoc, const mat4& modelMatrix) const {
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); // Add this for safety
 
     glUseProgram(_program);
-    glUniformMatrix4fv(modelViewLoc, 1, GL_TRUE, modelMatrix);
-    glUniformMatrix4fv(projectionLoc, 1, GL_TRUE, projMatrix);
+    glUniformMatrix4fv(modelLoc, 1, GL_TRUE, modelMatrix);
 
-    glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, _indexCount, GL_UNSIGNED_INT, nullptr);
+    glBindVertexArray(_meshes[0]->vao.get());
+    glDrawElements(GL_TRIANGLES, _meshes[0]->indexCount, GL_UNSIGNED_INT, nullptr);
+    recordDrawCall(1, _meshes[0]->indexCount / 3);
     glBindVertexArray(0);
 
 }
 
+const MeshHandle& Head::getMesh(int lod) const {
+    return _meshes[lod];
+}
+
 } // namespace spider
\ No newline at end of file
@@ -1,6 +1,8 @@
 // Leg.cpp
 #include "spider/Leg.h"
-#include <cmath>     // For atan2, sqrt, acos, M_PI
+#include "spider/LegKinematics.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace spider {
@@ -29,6 +31,13 @@ namespace spider {
         }
     }
 
+    void Leg::setJointAngles(const float* angles, int count) {
+        int n = std::min(count, (int)jointAngles.size());
+        for (int i = 0; i < n; ++i) {
+            jointAngles[i] = angles[i];
+        }
+    }
+
     const std::vector<float>& Leg::getJointAngles() const {
         return jointAngles;
     }
@@ -36,52 +45,60 @@ namespace spider {
     const std::vector<vec3>& Leg::getSegmentEnds() const {
         return segmentEnds;
     }
-    // Applied from matlab (which is written by us inspired from "NUMERICAL METHODS FOR MECHANICAL ENGINEERING-01 (MECH307”))by help of gemini.
-    void Leg::forwardKinematics(const std::vector<float>& theta_deg, float L, std::vector<float>& x, std::vector<float>& y) {
-        x.assign(theta_deg.size() + 1, 0.0f);
-        y.assign(theta_deg.size() + 1, 0.0f);
-        float a = 0.0f;
-        for (size_t i = 0; i < theta_deg.size(); ++i) {
-            a += theta_deg[i];
-            float rad = a * static_cast<float>(M_PI) / 180.0f;
-            x[i + 1] = x[i] + L * std::cos(rad);
-            y[i + 1] = y[i] + L * std::sin(rad);
+
+    void Leg::appendSegmentTransforms(const mat4& root, const float* angles, std::vector<mat4>& out,
+                                      int jointStride) const {
+        if (jointStride <= 1) {
+            // Same chain as draw(): rotate about the joint, emit the segment, move to its end
+            mat4 current = root;
+            for (size_t i = 0; i < segments.size(); ++i) {
+                current = current * RotateZ(angles[i]);
+                out.push_back(current * Scale(segments[i].getLength(), segments[i].getThickness(), segments[i].getThickness()));
+                current = current * Translate(segments[i].getLength(), 0.0f, 0.0f);
+            }
+            return;
         }
+
+        // Every joint turns about local Z, so the chain is planar: walk the joint
+        // positions and span a cuboid across each run of jointStride segments
+        const int n = static_cast<int>(segments.size());
+        float heading = 0.0f;
+        float x = 0.0f, y = 0.0f;
+        for (int first = 0; first < n; first += jointStride) {
+            const int last = std::min(first + jointStride, n);
+            const float startX = x, startY = y;
+            for (int i = first; i < last; ++i) {
+                heading += angles[i];
+                const float rad = heading * static_cast<float>(M_PI) / 180.0f;
+                x += segments[i].getLength() * std::cos(rad);
+                y += segments[i].getLength() * std::sin(rad);
+            }
+            const float dx = x - startX, dy = y - startY;
+            const float span = std::sqrt(dx * dx + dy * dy);
+            const float direction = std::atan2(dy, dx) * 180.0f / static_cast<float>(M_PI);
+            const float thickness = segments[first].getThickness();
+            out.push_back(root * Translate(startX, startY, 0.0f) * RotateZ(direction) * Scale(span, thickness, thickness));
+        }
+    }
+
+    // Kinematics live in LegKinematics so the simulation can use them without GL
+    void Leg::forwardKinematics(const std::vector<float>& theta_deg, float L, std::vector<float>& x, std::vector<float>& y) {
+        int n = static_cast<int>(theta_deg.size());
+        x.resize(n + 1);
+        y.resize(n + 1);
+        spider::forwardKinematics(theta_deg.data(), n, L, x.data(), y.data());
     }
 
-    std::vector<float> Leg::inverseKinematicsCCD( // Applied from matlab (which is written by us inspired from "NUMERICAL METHODS FOR MECHANICAL ENGINEERING-01 (MECH307”))by help of gemini.
+    std::vector<float> Leg::inverseKinematicsCCD(
         float x_target, float y_target, float L, int n, int maxIter, float tol,
         const std::vector<float>& theta_min, const std::vector<float>& theta_max
     ) {
         std::vector<float> theta_deg(n, 0.0f);
-        std::vector<float> x, y;
-        for (int iter = 0; iter < maxIter; ++iter) {
-            forwardKinematics(theta_deg, L, x, y);
-            float dx = x.back() - x_target;
-            float dy = y.back() - y_target;
-            float d = std::sqrt(dx*dx + dy*dy);
-            if (d < tol) break;
-            for (int i = n-1; i >= 0; --i) {
-                forwardKinematics(theta_deg, L, x, y);
-                float jx = x[i], jy = y[i];
-                float eex = x.back(), eey = y.back();
-                float v1x = x_target - jx, v1y = y_target - jy;
-                float v2x = eex - jx,    v2y = eey - jy;
-                float a1 = std::atan2(v1y, v1x) * 180.0f / static_cast<float>(M_PI);
-                float a2 = std::atan2(v2y, v2x) * 180.0f / static_cast<float>(M_PI);
-                float da = a1 - a2;
-                theta_deg[i] += da;
-                // Clamp to limits
-                theta_deg[i] = std::min(std::max(theta_deg[i], theta_min[i]), theta_max[i]);
-            }
-        }
+        solveCCD(x_target, y_target, L, n, maxIter, tol, theta_min.data(), theta_max.data(), theta_deg.data());
         return theta_deg;
     }
 
-     void Leg::draw(GLuint modelViewLoc,
-                    GLuint projectionLoc,
-                    const mat4& modelMatrix,
-                    const mat4& projMatrix)
+     void Leg::draw(GLuint modelLoc, const mat4& modelMatrix)
      {
          segmentEnds.clear();
          segmentEnds.reserve(segments.size());
@@ -93,7 +110,7 @@ namespace spider {
              current = current * RotateZ(jointAngles[i]);
 
              // 2) Draw this segment
-             segments[i].draw(modelViewLoc, projectionLoc, current, projMatrix);
+             segments[i].draw(modelLoc, current);
 
              // 3) Advance to the end of this segment so next one attaches there
              current = current * Translate(segments[i].getLength(), 0.0f, 0.0f);
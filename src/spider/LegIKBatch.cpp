@@ -0,0 +1,138 @@
+// Description: Source file for the batched CCD leg solver.
+#include "spider/LegIKBatch.h"
+#include "utils/SimdMath.h"
+#include <algorithm>
+#include <vector>
+
+namespace spider {
+
+    namespace {
+        const float DEG_TO_RAD = 3.14159265358979f / 180.0f;
+        const float RAD_TO_DEG = 180.0f / 3.14159265358979f;
+
+        // Joint positions of every lane's chain, same accumulation as spider::forwardKinematics
+        void forwardKinematicsLanes(const simd::VFloat* theta, int n, simd::VFloat length,
+                                    simd::VFloat* x, simd::VFloat* y) {
+            simd::VFloat angle = simd::set1(0.0f);
+            x[0] = simd::set1(0.0f);
+            y[0] = simd::set1(0.0f);
+            for (int i = 0; i < n; ++i) {
+                angle = angle + theta[i];
+                simd::VFloat s, c;
+                simd::sincos(angle * simd::set1(DEG_TO_RAD), s, c);
+                x[i + 1] = x[i] + length * c;
+                y[i + 1] = y[i] + length * s;
+            }
+        }
+
+        // Gathers one value per lane; lanes past the last leg repeat it so they stay finite
+        simd::VFloat gatherLanes(const float* base, size_t first, size_t stride, size_t valid) {
+            float lanes[simd::WIDTH];
+            for (int l = 0; l < simd::WIDTH; ++l) {
+                size_t leg = first + std::min(static_cast<size_t>(l), valid - 1);
+                lanes[l] = base[leg * stride];
+            }
+            return simd::load(lanes);
+        }
+
+        // One leg at a time through spider::solveCCD, for chains longer than the lane buffers
+        // and for builds without a vector instruction set
+        void solveScalar(const LegIKBatch& batch) {
+            const int n = batch.segmentCount;
+            for (size_t leg = 0; leg < batch.legCount; ++leg) {
+                float* theta = batch.thetaOut + leg * n;
+                if (!batch.thetaStart) {
+                    std::fill(theta, theta + n, 0.0f);
+                } else if (batch.thetaStart != batch.thetaOut) {
+                    std::copy(batch.thetaStart + leg * n, batch.thetaStart + (leg + 1) * n, theta);
+                }
+                solveCCD(batch.targetX[leg], batch.targetY[leg], batch.segmentLength, n,
+                         batch.maxIter, batch.tolerance,
+                         batch.thetaMin + leg * batch.limitStride,
+                         batch.thetaMax + leg * batch.limitStride, theta);
+            }
+        }
+    }
+
+    void solveLegIKBatch(const LegIKBatch& batch) {
+        const int n = batch.segmentCount;
+        if (batch.legCount == 0 || n <= 0) {
+            return;
+        }
+        // Without vector units the emulated lanes are slower than libm
+#if defined(SPIDER_SIMD_SCALAR)
+        const bool vectorized = false;
+#else
+        const bool vectorized = true;
+#endif
+        if (!vectorized || n > LEG_KINEMATICS_MAX_SEGMENTS) {
+            solveScalar(batch);
+            return;
+        }
+
+        // Stack arrays rather than std::vector: C++11 allocators do not honour the 32-byte alignment of AVX lanes
+        const simd::VFloat length = simd::set1(batch.segmentLength);
+        const simd::VFloat tolerance = simd::set1(batch.tolerance);
+        simd::VFloat theta[LEG_KINEMATICS_MAX_SEGMENTS], thetaMin[LEG_KINEMATICS_MAX_SEGMENTS], thetaMax[LEG_KINEMATICS_MAX_SEGMENTS];
+        simd::VFloat x[LEG_KINEMATICS_MAX_SEGMENTS + 1], y[LEG_KINEMATICS_MAX_SEGMENTS + 1];
+
+        for (size_t first = 0; first < batch.legCount; first += simd::WIDTH) {
+            const size_t valid = std::min(static_cast<size_t>(simd::WIDTH), batch.legCount - first);
+            const simd::VFloat tx = gatherLanes(batch.targetX, first, 1, valid);
+            const simd::VFloat ty = gatherLanes(batch.targetY, first, 1, valid);
+            for (int j = 0; j < n; ++j) {
+                theta[j] = batch.thetaStart ? gatherLanes(batch.thetaStart + j, first, n, valid) : simd::set1(0.0f);
+                thetaMin[j] = gatherLanes(batch.thetaMin + j, first, batch.limitStride, valid);
+                thetaMax[j] = gatherLanes(batch.thetaMax + j, first, batch.limitStride, valid);
+            }
+
+            // Lanes that met the tolerance keep their angles, like the scalar early break
+            simd::VFloat converged = simd::falseMask();
+            for (int iter = 0; iter < batch.maxIter; ++iter) {
+                forwardKinematicsLanes(theta, n, length, x, y);
+                simd::VFloat dx = x[n] - tx;
+                simd::VFloat dy = y[n] - ty;
+                converged = converged | simd::less(simd::sqrt(dx * dx + dy * dy), tolerance);
+                if (simd::allSet(converged)) {
+                    break;
+                }
+
+                for (int i = n - 1; i >= 0; --i) {
+                    const simd::VFloat jx = x[i], jy = y[i];
+                    simd::VFloat a1 = simd::atan2(ty - jy, tx - jx) * simd::set1(RAD_TO_DEG);
+                    simd::VFloat a2 = simd::atan2(y[n] - jy, x[n] - jx) * simd::set1(RAD_TO_DEG);
+                    simd::VFloat next = simd::min(simd::max(theta[i] + (a1 - a2), thetaMin[i]), thetaMax[i]);
+                    next = simd::select(converged, theta[i], next);
+                    simd::VFloat applied = next - theta[i];
+                    theta[i] = next;
+
+                    // Swing the downstream points about joint i; converged lanes rotate by zero
+                    simd::VFloat s, c;
+                    simd::sincos(applied * simd::set1(DEG_TO_RAD), s, c);
+                    for (int k = i + 1; k <= n; ++k) {
+                        simd::VFloat rx = x[k] - jx, ry = y[k] - jy;
+                        x[k] = jx + rx * c - ry * s;
+                        y[k] = jy + rx * s + ry * c;
+                    }
+                }
+            }
+
+            for (int j = 0; j < n; ++j) {
+                float lanes[simd::WIDTH];
+                simd::store(lanes, theta[j]);
+                for (size_t l = 0; l < valid; ++l) {
+                    batch.thetaOut[(first + l) * n + j] = lanes[l];
+                }
+            }
+        }
+    }
+
+    int legIKBatchWidth() {
+        return simd::WIDTH;
+    }
+
+    const char* legIKBatchInstructionSet() {
+        return simd::instructionSet();
+    }
+
+} // namespace spider
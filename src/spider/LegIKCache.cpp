@@ -0,0 +1,165 @@
+// Description: Source file for LegIKCache.
+#include "spider/LegIKCache.h"
+#include "global/GlobalConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace spider {
+
+    namespace {
+        // FNV-1a over raw bytes; float fields hash by bit pattern
+        const uint64_t FNV_OFFSET = 1469598103934665603ull;
+        const uint64_t FNV_PRIME = 1099511628211ull;
+
+        void hashBytes(uint64_t& hash, const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * FNV_PRIME;
+            }
+        }
+
+        template <typename T>
+        void hashValue(uint64_t& hash, const T& value) {
+            hashBytes(hash, &value, sizeof value);
+        }
+    }
+
+    LegIKCache::LegIKCache(float quantum, bool enabled)
+        : quantum_(quantum), enabled_(enabled), hits_(0), misses_(0) {
+    }
+
+    LegIKCache& LegIKCache::instance() {
+        static LegIKCache cache(LEG_IK_CACHE_QUANTUM, LEG_IK_CACHE_ENABLED);
+        return cache;
+    }
+
+    bool LegIKCache::isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void LegIKCache::setEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    void LegIKCache::setQuantum(float quantum) {
+        quantum_ = quantum;
+        clear();
+    }
+
+    float LegIKCache::getQuantum() const {
+        return quantum_;
+    }
+
+    size_t LegIKCache::KeyHash::operator()(const Key& key) const {
+        uint64_t hash = key.config;
+        hashValue(hash, key.x);
+        hashValue(hash, key.y);
+        return static_cast<size_t>(hash);
+    }
+
+    uint64_t LegIKCache::configHash(LegIKMethod method, const LegIKProblem& problem) {
+        const int n = problem.segmentCount;
+        uint64_t hash = FNV_OFFSET;
+        hashValue(hash, static_cast<int>(method));
+        hashValue(hash, n);
+        hashValue(hash, problem.segmentLength);
+        hashValue(hash, problem.maxIter);
+        hashValue(hash, problem.tolerance);
+        hashBytes(hash, problem.thetaMin, n * sizeof(float));
+        hashBytes(hash, problem.thetaMax, n * sizeof(float));
+        if (problem.restPose) {
+            hashBytes(hash, problem.restPose, n * sizeof(float));
+        }
+        return hash;
+    }
+
+    LegIKCache::Key LegIKCache::makeKey(LegIKMethod method, const LegIKProblem& problem) const {
+        Key key;
+        key.config = configHash(method, problem);
+        key.x = static_cast<int32_t>(std::lround(problem.targetX / quantum_));
+        key.y = static_cast<int32_t>(std::lround(problem.targetY / quantum_));
+        return key;
+    }
+
+    LegIKCache::Shard& LegIKCache::shardFor(const Key& key) {
+        return shards_[KeyHash()(key) % SHARD_COUNT];
+    }
+
+    LegIKResult LegIKCache::solve(LegIKMethod method, const LegIKProblem& problem, float* thetaDeg) {
+        const int n = problem.segmentCount;
+        if (n > LEG_KINEMATICS_MAX_SEGMENTS) {
+            std::fill(thetaDeg, thetaDeg + n, 0.0f);
+            return getLegIKSolver(method).solve(problem, thetaDeg);
+        }
+
+        const Key key = makeKey(method, problem);
+        Shard& shard = shardFor(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                std::copy(it->second.angles.begin(), it->second.angles.begin() + n, thetaDeg);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                LegIKResult result;
+                result.iterations = 0;
+                result.residual = it->second.residual;
+                return result;
+            }
+        }
+
+        // Solve outside the lock; if another thread raced us, both computed the same pose
+        LegIKProblem snapped = problem;
+        snapped.targetX = key.x * quantum_;
+        snapped.targetY = key.y * quantum_;
+        Entry entry;
+        entry.angles.fill(0.0f);
+        LegIKResult result = getLegIKSolver(method).solve(snapped, entry.angles.data());
+        entry.residual = result.residual;
+        std::copy(entry.angles.begin(), entry.angles.begin() + n, thetaDeg);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.insert(std::make_pair(key, entry));
+        return result;
+    }
+
+    void LegIKCache::precompute(LegIKMethod method, const LegIKProblem& problem, float minTargetY, float maxTargetY) {
+        float angles[LEG_KINEMATICS_MAX_SEGMENTS];
+        if (problem.segmentCount > LEG_KINEMATICS_MAX_SEGMENTS) {
+            return;
+        }
+        LegIKProblem step = problem;
+        const int32_t first = static_cast<int32_t>(std::lround(minTargetY / quantum_));
+        const int32_t last = static_cast<int32_t>(std::lround(maxTargetY / quantum_));
+        for (int32_t q = first; q <= last; ++q) {
+            step.targetY = q * quantum_;
+            solve(method, step, angles);
+        }
+    }
+
+    LegIKCacheStats LegIKCache::getStats() const {
+        LegIKCacheStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.entries = 0;
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.entries += shard.entries.size();
+        }
+        return stats;
+    }
+
+    void LegIKCache::resetStats() {
+        hits_.store(0, std::memory_order_relaxed);
+        misses_.store(0, std::memory_order_relaxed);
+    }
+
+    void LegIKCache::clear() {
+        for (Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+        }
+    }
+
+} // namespace spider
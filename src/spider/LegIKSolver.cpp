@@ -0,0 +1,251 @@
+// Description: Source file for the leg IK solvers.
+#include "spider/LegIKSolver.h"
+#include "spider/LegKinematics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+namespace spider {
+
+    namespace {
+        const float DEG_TO_RAD = static_cast<float>(M_PI) / 180.0f;
+        const float RAD_TO_DEG = 180.0f / static_cast<float>(M_PI);
+        const float EPSILON = 1e-6f;
+
+        std::atomic<uint64_t> g_executedSolves(0);
+        std::atomic<uint64_t> g_skippedSolves(0);
+
+        float clampAngle(float value, float lo, float hi) {
+            return std::min(std::max(value, lo), hi);
+        }
+
+        // Into (-180, 180], so angles from atan2 differences compare against the limits sensibly
+        float wrapDegrees(float degrees) {
+            degrees = std::fmod(degrees + 180.0f, 360.0f);
+            if (degrees <= 0.0f) {
+                degrees += 360.0f;
+            }
+            return degrees - 180.0f;
+        }
+
+        // Joint position buffers on the stack for the usual chain lengths
+        class PointBuffer {
+        public:
+            explicit PointBuffer(int n) : x(stackX), y(stackY) {
+                if (n > LEG_KINEMATICS_MAX_SEGMENTS) {
+                    heap.resize(2 * (n + 1));
+                    x = heap.data();
+                    y = heap.data() + n + 1;
+                }
+            }
+            PointBuffer(const PointBuffer&) = delete;
+            PointBuffer& operator=(const PointBuffer&) = delete;
+
+            float* x;
+            float* y;
+        private:
+            float stackX[LEG_KINEMATICS_MAX_SEGMENTS + 1];
+            float stackY[LEG_KINEMATICS_MAX_SEGMENTS + 1];
+            std::vector<float> heap;
+        };
+
+        class CCDSolver : public LegIKSolver {
+        public:
+            LegIKMethod getMethod() const override { return LegIKMethod::CCD; }
+            const char* getName() const override { return "ccd"; }
+
+            LegIKResult solve(const LegIKProblem& p, float* thetaDeg) const override {
+                LegIKResult result;
+                result.iterations = solveCCD(p.targetX, p.targetY, p.segmentLength, p.segmentCount,
+                                             p.maxIter, p.tolerance, p.thetaMin, p.thetaMax, thetaDeg);
+                result.residual = legIKResidual(p, thetaDeg);
+                return result;
+            }
+        };
+
+        class FABRIKSolver : public LegIKSolver {
+        public:
+            LegIKMethod getMethod() const override { return LegIKMethod::FABRIK; }
+            const char* getName() const override { return "fabrik"; }
+
+            LegIKResult solve(const LegIKProblem& p, float* thetaDeg) const override {
+                const int n = p.segmentCount;
+                const float L = p.segmentLength;
+                PointBuffer points(n);
+                float* x = points.x;
+                float* y = points.y;
+
+                LegIKResult result;
+                result.iterations = p.maxIter;
+                for (int iter = 0; iter < p.maxIter; ++iter) {
+                    forwardKinematics(thetaDeg, n, L, x, y);
+                    float dx = x[n] - p.targetX, dy = y[n] - p.targetY;
+                    if (std::sqrt(dx * dx + dy * dy) < p.tolerance) {
+                        result.iterations = iter;
+                        break;
+                    }
+
+                    // Backward pass: pin the end effector to the target
+                    x[n] = p.targetX;
+                    y[n] = p.targetY;
+                    for (int i = n - 1; i >= 0; --i) {
+                        placeAtDistance(x[i + 1], y[i + 1], x[i], y[i], L);
+                    }
+                    // Forward pass: pin the root back to the origin
+                    x[0] = 0.0f;
+                    y[0] = 0.0f;
+                    for (int i = 0; i < n; ++i) {
+                        placeAtDistance(x[i], y[i], x[i + 1], y[i + 1], L);
+                    }
+
+                    // Back to joint angles, clamping each joint before the next one is measured
+                    float previous = 0.0f;
+                    for (int i = 0; i < n; ++i) {
+                        float absolute = std::atan2(y[i + 1] - y[i], x[i + 1] - x[i]) * RAD_TO_DEG;
+                        float relative = clampAngle(wrapDegrees(absolute - previous), p.thetaMin[i], p.thetaMax[i]);
+                        thetaDeg[i] = relative;
+                        previous += relative;
+                    }
+                }
+                result.residual = legIKResidual(p, thetaDeg);
+                return result;
+            }
+
+        private:
+            // Moves (px, py) onto the circle of radius L around (ax, ay), along the line between them
+            static void placeAtDistance(float ax, float ay, float& px, float& py, float L) {
+                float dx = px - ax, dy = py - ay;
+                float length = std::sqrt(dx * dx + dy * dy);
+                if (length < EPSILON) {
+                    dx = 1.0f;
+                    dy = 0.0f;
+                    length = 1.0f;
+                }
+                px = ax + dx / length * L;
+                py = ay + dy / length * L;
+            }
+        };
+
+        // Reduced-DOF closed form. Joint 0 and the middle joint stay free; every other
+        // joint is held at the rest pose (or its incoming angle), so each half of the
+        // leg is a rigid bone and the pose follows from the law of cosines.
+        class TwoBoneSolver : public LegIKSolver {
+        public:
+            LegIKMethod getMethod() const override { return LegIKMethod::TwoBone; }
+            const char* getName() const override { return "two_bone"; }
+
+            LegIKResult solve(const LegIKProblem& p, float* thetaDeg) const override {
+                const int n = p.segmentCount;
+                if (n < 2) {
+                    return getLegIKSolver(LegIKMethod::CCD).solve(p, thetaDeg);
+                }
+                const int knee = n / 2;
+                for (int i = 0; i < n; ++i) {
+                    float held = p.restPose ? p.restPose[i] : thetaDeg[i];
+                    thetaDeg[i] = clampAngle(held, p.thetaMin[i], p.thetaMax[i]);
+                }
+
+                // Chord of each bone in its own base frame (free joint at zero)
+                float boneAngleA, boneAngleB, bendA;
+                float a = boneChord(thetaDeg, 0, knee, p.segmentLength, boneAngleA, bendA);
+                float unusedBend;
+                float b = boneChord(thetaDeg, knee, n, p.segmentLength, boneAngleB, unusedBend);
+
+                float d = std::sqrt(p.targetX * p.targetX + p.targetY * p.targetY);
+                float toTarget = std::atan2(p.targetY, p.targetX);
+                d = clampAngle(d, std::fabs(a - b) + EPSILON, a + b - EPSILON);
+                float rootAngle = std::acos(clampAngle((a * a + d * d - b * b) / (2.0f * a * d), -1.0f, 1.0f));
+                float kneeAngle = std::acos(clampAngle((a * a + b * b - d * d) / (2.0f * a * b), -1.0f, 1.0f));
+
+                // Try knee up and knee down, keep whichever lands closer after clamping
+                float best[2] = {thetaDeg[0], thetaDeg[knee]};
+                float bestResidual = -1.0f;
+                for (int side = -1; side <= 1; side += 2) {
+                    float chordA = toTarget + side * rootAngle;
+                    float chordB = chordA - side * (static_cast<float>(M_PI) - kneeAngle);
+                    float root = wrapDegrees((chordA - boneAngleA) * RAD_TO_DEG);
+                    root = clampAngle(root, p.thetaMin[0], p.thetaMax[0]);
+                    float middle = wrapDegrees((chordB - boneAngleB) * RAD_TO_DEG - root - bendA);
+                    middle = clampAngle(middle, p.thetaMin[knee], p.thetaMax[knee]);
+
+                    thetaDeg[0] = root;
+                    thetaDeg[knee] = middle;
+                    float residual = legIKResidual(p, thetaDeg);
+                    if (bestResidual < 0.0f || residual < bestResidual) {
+                        bestResidual = residual;
+                        best[0] = root;
+                        best[1] = middle;
+                    }
+                }
+                thetaDeg[0] = best[0];
+                thetaDeg[knee] = best[1];
+
+                LegIKResult result;
+                result.iterations = 1;
+                result.residual = bestResidual;
+                return result;
+            }
+
+        private:
+            // Length and direction (radians) of the chord over segments [first, last) with the
+            // first joint at zero; `bend` receives the summed angles of the fixed joints in degrees
+            static float boneChord(const float* thetaDeg, int first, int last, float L, float& angle, float& bend) {
+                float cx = 0.0f, cy = 0.0f, cumulative = 0.0f;
+                for (int i = first; i < last; ++i) {
+                    if (i != first) {
+                        cumulative += thetaDeg[i];
+                    }
+                    cx += L * std::cos(cumulative * DEG_TO_RAD);
+                    cy += L * std::sin(cumulative * DEG_TO_RAD);
+                }
+                angle = std::atan2(cy, cx);
+                bend = cumulative;
+                return std::sqrt(cx * cx + cy * cy);
+            }
+        };
+    }
+
+    const LegIKSolver& getLegIKSolver(LegIKMethod method) {
+        static const CCDSolver ccd;
+        static const FABRIKSolver fabrik;
+        static const TwoBoneSolver twoBone;
+        switch (method) {
+            case LegIKMethod::FABRIK:  return fabrik;
+            case LegIKMethod::TwoBone: return twoBone;
+            case LegIKMethod::CCD:
+            default:                   return ccd;
+        }
+    }
+
+    float legIKResidual(const LegIKProblem& problem, const float* thetaDeg) {
+        const int n = problem.segmentCount;
+        PointBuffer points(n);
+        forwardKinematics(thetaDeg, n, problem.segmentLength, points.x, points.y);
+        float dx = points.x[n] - problem.targetX;
+        float dy = points.y[n] - problem.targetY;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    void recordLegIKSolves(uint64_t executed, uint64_t skipped) {
+        if (executed) {
+            g_executedSolves.fetch_add(executed, std::memory_order_relaxed);
+        }
+        if (skipped) {
+            g_skippedSolves.fetch_add(skipped, std::memory_order_relaxed);
+        }
+    }
+
+    LegIKCounters getLegIKCounters() {
+        LegIKCounters counters;
+        counters.executed = g_executedSolves.load(std::memory_order_relaxed);
+        counters.skipped = g_skippedSolves.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+    void resetLegIKCounters() {
+        g_executedSolves.store(0, std::memory_order_relaxed);
+        g_skippedSolves.store(0, std::memory_order_relaxed);
+    }
+
+} // namespace spider
@@ -0,0 +1,72 @@
+// Description: Source file for the planar leg kinematics.
+#include "spider/LegKinematics.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace spider {
+
+    namespace {
+        const float DEG_TO_RAD = static_cast<float>(M_PI) / 180.0f;
+        const float RAD_TO_DEG = 180.0f / static_cast<float>(M_PI);
+    }
+
+    void forwardKinematics(const float* thetaDeg, int n, float L, float* x, float* y) {
+        x[0] = 0.0f;
+        y[0] = 0.0f;
+        float a = 0.0f;
+        for (int i = 0; i < n; ++i) {
+            a += thetaDeg[i];
+            float rad = a * DEG_TO_RAD;
+            x[i + 1] = x[i] + L * std::cos(rad);
+            y[i + 1] = y[i] + L * std::sin(rad);
+        }
+    }
+
+    // Applied from matlab (which is written by us inspired from "NUMERICAL METHODS FOR MECHANICAL ENGINEERING-01 (MECH307”))by help of gemini.
+    int solveCCD(float xTarget, float yTarget, float L, int n, int maxIter, float tol,
+                 const float* thetaMin, const float* thetaMax, float* thetaDeg) {
+        float stackX[LEG_KINEMATICS_MAX_SEGMENTS + 1], stackY[LEG_KINEMATICS_MAX_SEGMENTS + 1];
+        std::vector<float> heap;
+        float* x = stackX;
+        float* y = stackY;
+        if (n > LEG_KINEMATICS_MAX_SEGMENTS) {
+            heap.resize(2 * (n + 1));
+            x = heap.data();
+            y = heap.data() + n + 1;
+        }
+
+        for (int iter = 0; iter < maxIter; ++iter) {
+            // One full forward pass per sweep keeps rounding drift from the rotations bounded
+            forwardKinematics(thetaDeg, n, L, x, y);
+            float dx = x[n] - xTarget;
+            float dy = y[n] - yTarget;
+            if (std::sqrt(dx * dx + dy * dy) < tol) {
+                return iter;
+            }
+
+            for (int i = n - 1; i >= 0; --i) {
+                float jx = x[i], jy = y[i];
+                float a1 = std::atan2(yTarget - jy, xTarget - jx) * RAD_TO_DEG;
+                float a2 = std::atan2(y[n] - jy, x[n] - jx) * RAD_TO_DEG;
+                float next = std::min(std::max(thetaDeg[i] + (a1 - a2), thetaMin[i]), thetaMax[i]);
+                float applied = next - thetaDeg[i];
+                thetaDeg[i] = next;
+                if (applied == 0.0f) {
+                    continue;
+                }
+
+                // Turning joint i swings everything after it about (jx, jy)
+                float rad = applied * DEG_TO_RAD;
+                float c = std::cos(rad), s = std::sin(rad);
+                for (int k = i + 1; k <= n; ++k) {
+                    float rx = x[k] - jx, ry = y[k] - jy;
+                    x[k] = jx + rx * c - ry * s;
+                    y[k] = jy + rx * s + ry * c;
+                }
+            }
+        }
+        return maxIter;
+    }
+
+} // namespace spider
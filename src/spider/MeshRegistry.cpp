@@ -0,0 +1,102 @@
+// Description: Source file for MeshRegistry, sharing one GPU copy of each body-part mesh.
+#include "spider/MeshRegistry.h"
+#include "utils/Profiler.h"
+
+namespace spider {
+
+bool MeshKey::operator==(const MeshKey& other) const {
+    return part == other.part && stacks == other.stacks && slices == other.slices &&
+           radiusX == other.radiusX && radiusY == other.radiusY && radiusZ == other.radiusZ &&
+           noiseScale == other.noiseScale && noiseStrength == other.noiseStrength;
+}
+
+MeshRegistry::MeshRegistry()
+    : builds_(0),
+      reuses_(0) {
+}
+
+MeshRegistry& MeshRegistry::instance() {
+    static MeshRegistry registry;
+    return registry;
+}
+
+MeshHandle MeshRegistry::acquire(const MeshKey& key, const Builder& build) {
+    // Expired entries are reused in place, so the table stays as small as the set of keys
+    Entry* slot = nullptr;
+    for (Entry& entry : entries_) {
+        if (entry.key == key) {
+            if (MeshHandle mesh = entry.mesh.lock()) {
+                ++reuses_;
+                return mesh;
+            }
+            slot = &entry;
+            break;
+        }
+    }
+
+    PROFILE_SCOPE("MeshRegistry::build");
+    MeshData data;
+    build(data);
+    MeshHandle mesh = upload(data);
+    ++builds_;
+
+    if (slot == nullptr) {
+        entries_.push_back(Entry{key, mesh});
+    } else {
+        slot->mesh = mesh;
+    }
+    return mesh;
+}
+
+MeshRegistryStats MeshRegistry::getStats() const {
+    MeshRegistryStats stats = {0, builds_, reuses_, 0, entries_.capacity() * sizeof(Entry)};
+    for (const Entry& entry : entries_) {
+        if (MeshHandle mesh = entry.mesh.lock()) {
+            ++stats.meshes;
+            stats.gpuBytes += mesh->gpuBytes;
+            stats.cpuBytes += sizeof(Mesh);
+        }
+    }
+    return stats;
+}
+
+std::shared_ptr<Mesh> MeshRegistry::upload(const MeshData& data) {
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    mesh->indexCount = static_cast<GLsizei>(data.indices.size());
+    mesh->floatsPerVertex = data.floatsPerVertex;
+    mesh->gpuBytes = data.vertices.size() * sizeof(GLfloat) + data.indices.size() * sizeof(GLuint);
+
+    mesh->vao = GLVertexArray::create();
+    mesh->vbo = GLBuffer::create();
+    mesh->ebo = GLBuffer::create();
+
+    glBindVertexArray(mesh->vao.get());
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(GLfloat), data.vertices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo.get());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(GLuint), data.indices.data(), GL_STATIC_DRAW);
+
+    bindMeshVertexLayout(*mesh);
+
+    glBindVertexArray(0);
+    return mesh;
+}
+
+void bindMeshVertexLayout(const Mesh& mesh) {
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo.get());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo.get());
+
+    const GLsizei stride = mesh.floatsPerVertex * sizeof(GLfloat);
+    // Position attribute
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    // Normal attribute
+    if (mesh.floatsPerVertex >= 6) {
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(GLfloat)));
+    }
+}
+
+} // namespace spider
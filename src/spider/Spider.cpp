@@ -1,125 +1,137 @@
-// Description: Source file for the Spider class, implementing its behavior and rendering.
+// Description: Source file for the Spider class, implementing its simulation behavior.
 #include "spider/Spider.h"
 #include "global/GlobalConfig.h"
-#include "spider/Leg.h"
+#include "spider/LegIKBatch.h"
+#include "spider/LegIKCache.h"
+#include "spider/Cephalothorax.h"
+#include "utils/Profiler.h"
+#include <algorithm>
 #include <cmath> // For M_PI, sin, cos, fmod
+#include <limits>
 
 
 namespace spider {
 
-    Spider::Spider(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader)
-    : cephalothorax(cephalothoraxShader),
-      abdomen(abdomenShader),
-      head(cephalothoraxShader),
-      leftEye(eyeShader),
-      rightEye(eyeShader),
-      leftEye2(eyeShader),
-      rightEye2(eyeShader),
-      leg(legShader, 7, 0.6f, 1.3f),
-      leg2(legShader, 7, 0.6f, 1.3f),
-      leg3(legShader, 7, 0.6f, 1.5f),
-      leg4(legShader, 7, 0.6f, 1.5f),
-      leg5(legShader, 7, 0.6f, 1.3f),
-      leg6(legShader, 7, 0.6f, 1.3f),
-      leg7(legShader, 7, 0.6f, 1.5f),
-      leg8(legShader, 7, 0.6f, 1.5f),
-      position(BODY_START_X, BODY_START_Y, BODY_START_Z),
-      current_forward_vector_(0.0f, 0.0f, 1.0f),
-      is_walking_forward_(false),
-      is_walking_backward_(false),
-      is_turning_left_(false),
-      is_turning_right_(false),
-      walk_speed_(1.5f),
-      turn_speed_(90.0f),
-      current_yaw_angle_(0.0f),
-      leg_animation_cycle_(0.0f),
-      leg_animation_speed_(1.4f),
-      max_leg_swing_angle_(15.0f),
-      base_abdomen_tilt_angle_(ABDOMEN_TILT_ANGLE),
-      abdomen_shake_cycle_(0.0f),
-      abdomen_shake_speed_(3.0f),
-      max_abdomen_shake_amplitude_(5.0f) {
-
-        std::vector<float> angles = {20.0f, 5.0f, -10.0f, -35.0f, -20.0f, -30.0f, -10.0f};
-        leg.setJointAngles(angles);
-        leg2.setJointAngles(angles);
-        leg3.setJointAngles(angles);
-        leg4.setJointAngles(angles);
-        leg5.setJointAngles(angles);
-        leg6.setJointAngles(angles);
-        leg7.setJointAngles(angles);
-        leg8.setJointAngles(angles);
+    Spider::Spider()
+    : ik_solved_height_(std::numeric_limits<float>::quiet_NaN()),
+      walk_speed_(SPIDER_WALK_SPEED),
+      turn_speed_(SPIDER_TURN_SPEED),
+      leg_animation_speed_(LEG_ANIMATION_SPEED),
+      abdomen_shake_speed_(ABDOMEN_SHAKE_SPEED) {
+
+        state_.position = vec3(BODY_START_X, BODY_START_Y, BODY_START_Z);
+        state_.forward = vec3(0.0f, 0.0f, 1.0f);
+        state_.yaw = 0.0f;
+        state_.scale = 1.0f;
+        state_.walkingForward = false;
+        state_.walkingBackward = false;
+        state_.turningLeft = false;
+        state_.turningRight = false;
+        state_.legAnimationCycle = 0.0f;
+        state_.abdomenShakeCycle = 0.0f;
+        state_.jumpTriggered = false;
+        state_.jumping = false;
+        state_.jumpTime = 0.0f;
+
+        for (int i = 0; i < LEG_COUNT; ++i) {
+            for (int j = 0; j < LEG_SEGMENT_COUNT; ++j) {
+                state_.jointAngles[i][j] = LEG_REST_JOINT_ANGLES[j];
+            }
+            leg_ik_methods_[i] = LegIKMethod::CCD;
+        }
 
     }
 
 
 
 void Spider::setPosition(const vec3& pos) {
-    position = pos;
+    state_.position = pos;
 }
 
 const vec3& Spider::getPosition() const {
-    return position;
+    return state_.position;
 }
 
 void Spider::setScale(float scale) {
-    scale_ = scale;
+    state_.scale = scale;
 }
 
 float Spider::getScale() const {
-    return scale_;
+    return state_.scale;
+}
+
+const SpiderState& Spider::getState() const {
+    return state_;
+}
+
+void Spider::setLegIKMethod(int leg, LegIKMethod method) {
+    if (leg >= 0 && leg < LEG_COUNT && leg_ik_methods_[leg] != method) {
+        leg_ik_methods_[leg] = method;
+        ik_solved_height_ = std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
+LegIKMethod Spider::getLegIKMethod(int leg) const {
+    return leg_ik_methods_[leg];
 }
 
 void Spider::startWalkingForward() {
-    is_walking_forward_ = true;
-    is_walking_backward_ = false;
+    state_.walkingForward = true;
+    state_.walkingBackward = false;
 }
 
 void Spider::stopWalkingForward() {
-    is_walking_forward_ = false;
+    state_.walkingForward = false;
 }
 
 void Spider::startWalkingBackward() {
-    is_walking_backward_ = true;
-    is_walking_forward_ = false;
+    state_.walkingBackward = true;
+    state_.walkingForward = false;
 }
 
 void Spider::stopWalkingBackward() {
-    is_walking_backward_ = false;
+    state_.walkingBackward = false;
 }
 
 void Spider::startTurningLeft() {
-    is_turning_left_ = true;
-    is_turning_right_ = false;
+    state_.turningLeft = true;
+    state_.turningRight = false;
 }
 
 void Spider::stopTurningLeft() {
-    is_turning_left_ = false;
+    state_.turningLeft = false;
 }
 
 void Spider::startTurningRight() {
-    is_turning_right_ = true;
-    is_turning_left_ = false;
+    state_.turningRight = true;
+    state_.turningLeft = false;
 }
 
 void Spider::stopTurningRight() {
-    is_turning_right_ = false;
+    state_.turningRight = false;
+}
+
+void Spider::triggerJump() {
+    state_.jumpTriggered = true;
+}
+
+bool Spider::isJumpTriggered() const {
+    return state_.jumpTriggered;
 }
 
 std::vector<std::pair<float, float>> Spider::getXYLengthsForAllAttachments(const std::vector<vec3>& attachPoints) {
     std::vector<std::pair<float, float>> results;
     results.reserve(attachPoints.size());
-    float dx = 3.0f; // Adjust as needed
+    float dx = LEG_IK_TARGET_REACH;
 
     for (const auto& pt : attachPoints) {
-        float dy = pt.y - position.y; // Include the spider's vertical position
+        float dy = pt.y - state_.position.y; // Include the spider's vertical position
         results.emplace_back(dx, dy);
     }
     return results;
 }
 
 void Spider::applyIKToAllLegs(
-    std::vector<spider::Leg*>& legs,
     const std::vector<vec3>& attachPoints,
     float segmentLength,
     int numSegments,
@@ -128,321 +140,202 @@ void Spider::applyIKToAllLegs(
     const std::vector<std::vector<float>>& theta_min_all,
     const std::vector<std::vector<float>>& theta_max_all
 ) {
+    PROFILE_SCOPE("Spider::applyIKToAllLegs");
 
     auto xyTargets = getXYLengthsForAllAttachments(attachPoints);
-    for (size_t i = 0; i < legs.size(); ++i) {
-        // Adjust the y-coordinate dynamically for each attachPoint
-        float x_target = xyTargets[i].first;
-        float y_target = xyTargets[i].second;
-        const auto& theta_min = theta_min_all[i];
-        const auto& theta_max = theta_max_all[i];
-        std::vector<float> angles = legs[i]->inverseKinematicsCCD(
-            x_target, y_target, segmentLength, numSegments, maxIter, tol, theta_min, theta_max
-        );
-
-        legs[i]->setJointAngles(angles);
+    size_t legCount = std::min(xyTargets.size(), static_cast<size_t>(LEG_COUNT));
+    int segmentCount = std::min(numSegments, LEG_SEGMENT_COUNT);
+
+    // Start from the current pose when it has the solver's shape, from zero otherwise
+    const bool warmStart = numSegments == LEG_SEGMENT_COUNT;
+    recordLegIKSolves(legCount, 0);
+
+    // The shared cache turns every leg into a lookup of its snapped target
+    LegIKCache& cache = LegIKCache::instance();
+    if (cache.isEnabled()) {
+        std::vector<float> angles(numSegments);
+        for (size_t i = 0; i < legCount; ++i) {
+            LegIKProblem problem;
+            problem.targetX = xyTargets[i].first;
+            problem.targetY = xyTargets[i].second;
+            problem.segmentLength = segmentLength;
+            problem.segmentCount = numSegments;
+            problem.maxIter = maxIter;
+            problem.tolerance = tol;
+            problem.thetaMin = theta_min_all[i].data();
+            problem.thetaMax = theta_max_all[i].data();
+            problem.restPose = warmStart ? LEG_IK_FOLDED_POSE : nullptr;
+            cache.solve(leg_ik_methods_[i], problem, angles.data());
+            std::copy(angles.begin(), angles.begin() + segmentCount, state_.jointAngles[i]);
+        }
+        return;
+    }
+
+    // CCD legs are flattened into one SIMD batch; legs on other solvers go one at a time
+    std::vector<size_t> batchedLegs;
+    std::vector<float> targetX, targetY, thetaMin, thetaMax, thetaStart;
+    std::vector<float> angles(numSegments);
+    for (size_t i = 0; i < legCount; ++i) {
+        if (leg_ik_methods_[i] == LegIKMethod::CCD) {
+            batchedLegs.push_back(i);
+            targetX.push_back(xyTargets[i].first);
+            targetY.push_back(xyTargets[i].second);
+            thetaMin.insert(thetaMin.end(), theta_min_all[i].begin(), theta_min_all[i].begin() + numSegments);
+            thetaMax.insert(thetaMax.end(), theta_max_all[i].begin(), theta_max_all[i].begin() + numSegments);
+            if (warmStart) {
+                thetaStart.insert(thetaStart.end(), state_.jointAngles[i], state_.jointAngles[i] + numSegments);
+            }
+            continue;
+        }
+
+        LegIKProblem problem;
+        problem.targetX = xyTargets[i].first;
+        problem.targetY = xyTargets[i].second;
+        problem.segmentLength = segmentLength;
+        problem.segmentCount = numSegments;
+        problem.maxIter = maxIter;
+        problem.tolerance = tol;
+        problem.thetaMin = theta_min_all[i].data();
+        problem.thetaMax = theta_max_all[i].data();
+        problem.restPose = warmStart ? LEG_IK_FOLDED_POSE : nullptr;
+        if (warmStart) {
+            std::copy(state_.jointAngles[i], state_.jointAngles[i] + numSegments, angles.begin());
+        } else {
+            std::fill(angles.begin(), angles.end(), 0.0f);
+        }
+        getLegIKSolver(leg_ik_methods_[i]).solve(problem, angles.data());
+        std::copy(angles.begin(), angles.begin() + segmentCount, state_.jointAngles[i]);
+    }
+
+    if (batchedLegs.empty()) {
+        return;
+    }
+    angles.assign(batchedLegs.size() * numSegments, 0.0f);
+    LegIKBatch batch;
+    batch.legCount = batchedLegs.size();
+    batch.segmentCount = numSegments;
+    batch.segmentLength = segmentLength;
+    batch.maxIter = maxIter;
+    batch.tolerance = tol;
+    batch.targetX = targetX.data();
+    batch.targetY = targetY.data();
+    batch.thetaMin = thetaMin.data();
+    batch.thetaMax = thetaMax.data();
+    batch.limitStride = numSegments;
+    batch.thetaStart = warmStart ? thetaStart.data() : nullptr;
+    batch.thetaOut = angles.data();
+    solveLegIKBatch(batch);
+
+    for (size_t k = 0; k < batchedLegs.size(); ++k) {
+        const float* first = &angles[k * numSegments];
+        std::copy(first, first + segmentCount, state_.jointAngles[batchedLegs[k]]);
     }
 }
 
+void Spider::solveLegIK() {
+    static const std::vector<std::vector<float>> theta_min_all(
+        LEG_COUNT, std::vector<float>(LEG_JOINT_MIN_ANGLES, LEG_JOINT_MIN_ANGLES + LEG_SEGMENT_COUNT));
+    static const std::vector<std::vector<float>> theta_max_all(
+        LEG_COUNT, std::vector<float>(LEG_JOINT_MAX_ANGLES, LEG_JOINT_MAX_ANGLES + LEG_SEGMENT_COUNT));
+
+    // Attachment geometry and limits are fixed, so body height is the only input that moves
+    if (state_.position.y == ik_solved_height_) {
+        recordLegIKSolves(0, LEG_COUNT);
+        return;
+    }
+
+    const std::array<vec3, LEG_COUNT>& legAttachments = Cephalothorax::getRig().legAttachments;
+    const std::vector<vec3> attachPoints(legAttachments.begin(), legAttachments.end());
+    applyIKToAllLegs(attachPoints, LEG_SEGMENT_LENGTH, LEG_SEGMENT_COUNT,
+                     LEG_IK_MAX_ITERATIONS, LEG_IK_TOLERANCE, theta_min_all, theta_max_all);
+    ik_solved_height_ = state_.position.y;
+}
+
 void Spider::moveBodyUp() {
-    position.y += 0.05f; // Adjust this value as needed
-        if (position.y > 2.0f) {
-            position.y = 2.0f;
+    state_.position.y += 0.05f; // Adjust this value as needed
+        if (state_.position.y > BODY_MAX_Y) {
+            state_.position.y = BODY_MAX_Y;
         }
-    // Update leg positions with IK
-    std::vector<spider::Leg*> legs = {&leg, &leg2, &leg3, &leg4, &leg5, &leg6, &leg7, &leg8};
-    std::vector<vec3> attachPoints = cephalothorax.getLegAttachmentPoints();
-    float segmentLength = 0.6f;
-    int numSegments = 7;
-    int maxIter = 10;
-    float tol = 0.01f;
-
-    std::vector<std::vector<float>> theta_min_all(legs.size(), {30.0f, -15.0f, -40.0f, -30.0f, -30.0f, -30.0f, -30.0f});
-    std::vector<std::vector<float>> theta_max_all(legs.size(), {90.0f, 15.0f, 40.0f, 40.0f, 0.0f, 0.0f, 0.0f});
-
-    applyIKToAllLegs(legs, attachPoints, segmentLength, numSegments, maxIter, tol, theta_min_all, theta_max_all);
+    solveLegIK();
 }
 
 void Spider::moveBodyDown() {
-    position.y -= 0.05f; // Adjust this value as needed
-        if (position.y < 0.30f) {
-            position.y = 0.30f;
+    state_.position.y -= 0.05f; // Adjust this value as needed
+        if (state_.position.y < BODY_MIN_Y) {
+            state_.position.y = BODY_MIN_Y;
         }
-    // Update leg positions with IK
-    std::vector<spider::Leg*> legs = {&leg, &leg2, &leg3, &leg4, &leg5, &leg6, &leg7, &leg8};
-    std::vector<vec3> attachPoints = cephalothorax.getLegAttachmentPoints();
-    float segmentLength = 0.6f;
-    int numSegments = 7;
-    int maxIter = 10;
-    float tol = 0.01f;
-
-    std::vector<std::vector<float>> theta_min_all(legs.size(), {30.0f, -15.0f, -40.0f, -30.0f, -30.0f, -30.0f, -30.0f});
-    std::vector<std::vector<float>> theta_max_all(legs.size(), {90.0f, 15.0f, 40.0f, 40.0f, 0.0f, 0.0f, 0.0f});
-
-    applyIKToAllLegs(legs, attachPoints, segmentLength, numSegments, maxIter, tol, theta_min_all, theta_max_all);
+    solveLegIK();
 }
 
 void Spider::jump(float deltaTime, float jumpDuration) {
-    static float jumpTime = 0.0f;
-    static bool isJumping = false;
-
-    if (!isJumping) {
-        isJumping = true; // Start the jump
-        jumpTime = 0.0f;  // Reset jump time
+    // Jump progress lives in the per-spider state so several spiders can jump independently
+    if (!state_.jumping) {
+        state_.jumping = true; // Start the jump
+        state_.jumpTime = 0.0f;  // Reset jump time
     }
 
-    if (isJumping) {
-        if (jumpTime <= jumpDuration) {
+    if (state_.jumping) {
+        if (state_.jumpTime <= jumpDuration) {
             // Calculate height using a sine wave for smooth animation
-            float jumpHeight = 2.0f * sin((jumpTime / jumpDuration) * M_PI); // Adjust 0.5f for max height
-            position.y = BODY_START_Y + jumpHeight;
-
-            // Update leg positions with IK
-            std::vector<spider::Leg*> legs = {&leg, &leg2, &leg3, &leg4, &leg5, &leg6, &leg7, &leg8};
-            std::vector<vec3> attachPoints = cephalothorax.getLegAttachmentPoints();
-            float segmentLength = 0.6f;
-            int numSegments = 7;
-            int maxIter = 10;
-            float tol = 0.01f;
+            float jumpHeight = 2.0f * sin((state_.jumpTime / jumpDuration) * M_PI); // Adjust 0.5f for max height
+            state_.position.y = BODY_START_Y + jumpHeight;
 
-            std::vector<std::vector<float>> theta_min_all(legs.size(), {30.0f, -15.0f, -40.0f, -30.0f, -30.0f, -30.0f, -30.0f});
-            std::vector<std::vector<float>> theta_max_all(legs.size(), {90.0f, 15.0f, 40.0f, 40.0f, 0.0f, 0.0f, 0.0f});
+            solveLegIK();
 
-            applyIKToAllLegs(legs, attachPoints, segmentLength, numSegments, maxIter, tol, theta_min_all, theta_max_all);
-
-            jumpTime += deltaTime;
+            state_.jumpTime += deltaTime;
         } else {
             // Reset after jump
-            position.y = BODY_START_Y; // Reset to starting height
-            isJumping = false;
+            state_.position.y = BODY_START_Y; // Reset to starting height
+            state_.jumping = false;
         }
     }
 }
 
 void Spider::update(float deltaTime) {
-    if (is_turning_left_) {
-        current_yaw_angle_ += turn_speed_ * deltaTime;
+    PROFILE_SCOPE("Spider::update");
+    if (state_.turningLeft) {
+        state_.yaw += turn_speed_ * deltaTime;
     }
-    if (is_turning_right_) {
-        current_yaw_angle_ -= turn_speed_ * deltaTime;
+    if (state_.turningRight) {
+        state_.yaw -= turn_speed_ * deltaTime;
     }
-    current_yaw_angle_ = fmod(fmod(current_yaw_angle_, 360.0f) + 360.0f, 360.0f);
+    state_.yaw = fmod(fmod(state_.yaw, 360.0f) + 360.0f, 360.0f);
 
     auto to_radians = [](float degrees) {
         return degrees * (static_cast<float>(M_PI) / 180.0f);
     };
-    float yaw_rad = to_radians(current_yaw_angle_);
-    current_forward_vector_ = normalize(vec3(sin(yaw_rad), 0.0f, cos(yaw_rad)));
+    float yaw_rad = to_radians(state_.yaw);
+    state_.forward = normalize(vec3(sin(yaw_rad), 0.0f, cos(yaw_rad)));
 
-    if (is_walking_forward_) {
-        position += current_forward_vector_ * walk_speed_ * deltaTime;
-    } else if (is_walking_backward_) {
-        position -= current_forward_vector_ * walk_speed_ * deltaTime;
+    if (state_.walkingForward) {
+        state_.position += state_.forward * walk_speed_ * deltaTime;
+    } else if (state_.walkingBackward) {
+        state_.position -= state_.forward * walk_speed_ * deltaTime;
     }
 
-    // Prepare data for applyIKToAllLegs
-    std::vector<spider::Leg*> legs = {&leg, &leg2, &leg3, &leg4, &leg5, &leg6, &leg7, &leg8};
-    std::vector<vec3> attachPoints = cephalothorax.getLegAttachmentPoints();
-    float segmentLength = 0.6f;
-    int numSegments = 7;
-    int maxIter = 10;
-    float tol = 0.01f;
-
-    std::vector<std::vector<float>> theta_min_all(legs.size(), {30.0f, -15.0f, -40.0f, -30.0f, -30.0f, -30.0f, -30.0f});
-    std::vector<std::vector<float>> theta_max_all(legs.size(), {90.0f, 15.0f, 40.0f, 40.0f, 0.0f, 0.0f, 0.0f});
+    solveLegIK();
 
-    // Call applyIKToAllLegs
-    applyIKToAllLegs(legs, attachPoints, segmentLength, numSegments, maxIter, tol, theta_min_all, theta_max_all);
-
-    bool is_active = is_walking_forward_ || is_walking_backward_ || is_turning_left_ || is_turning_right_;
+    bool is_active = state_.walkingForward || state_.walkingBackward || state_.turningLeft || state_.turningRight;
     if (is_active) {
-        leg_animation_cycle_ += leg_animation_speed_ * deltaTime;
-        if (leg_animation_cycle_ > 1.0f) {
-            leg_animation_cycle_ -= 2.0f;
+        state_.legAnimationCycle += leg_animation_speed_ * deltaTime;
+        if (state_.legAnimationCycle > 1.0f) {
+            state_.legAnimationCycle -= 2.0f;
         }
 
-        abdomen_shake_cycle_ += abdomen_shake_speed_ * deltaTime;
-        if (abdomen_shake_cycle_ > 1.0f) {
-            abdomen_shake_cycle_ -= 1.0f;
+        state_.abdomenShakeCycle += abdomen_shake_speed_ * deltaTime;
+        if (state_.abdomenShakeCycle > 1.0f) {
+            state_.abdomenShakeCycle -= 1.0f;
         }
     }
 
-        if (jumpTriggered) {
+        if (state_.jumpTriggered) {
             jump(deltaTime, 1.0f); // 1.0f is the jump duration
             if (getPosition().y == BODY_START_Y) { // Check if the jump is complete
-                jumpTriggered = false; // Reset the trigger
+                state_.jumpTriggered = false; // Reset the trigger
             }
         }
 
 }
 
-        void Spider::draw(
-            GLuint modelViewLoc,
-            GLuint projectionLoc,
-            const mat4& viewMatrix,
-            const mat4& projMatrix
-        ) {
-        mat4 R_yaw = Angel::RotateY(current_yaw_angle_);
-        mat4 T_translation = Angel::Translate(position);
-        mat4 S_scale = Angel::Scale(scale_, scale_, scale_);
-        mat4 spiderWorldTransform = T_translation * R_yaw * S_scale;
-
-        mat4 V = viewMatrix;
-
-        mat4 modelCT_View = V * spiderWorldTransform;
-        cephalothorax.draw(modelViewLoc, projectionLoc, modelCT_View, projMatrix);
-
-        const float rz_abdomen = ABDOMEN_RADIUS * ABDOMEN_SCALE_Z;
-        float current_abdomen_tilt = base_abdomen_tilt_angle_;
-        // Abdomen shake is always calculated based on abdomen_shake_cycle_
-        // which pauses if spider is not active
-        float shake_offset = sin(abdomen_shake_cycle_ * 2.0f * static_cast<float>(M_PI)) * max_abdomen_shake_amplitude_;
-        current_abdomen_tilt += shake_offset;
-
-        mat4 R_tilt_ab    = Angel::RotateX(current_abdomen_tilt);
-        mat4 T_pivot_ab   = Angel::Translate(0, 0, -rz_abdomen*1.8f);
-        mat4 abdomenLocalToParent = R_tilt_ab * T_pivot_ab;
-        mat4 modelAbdomen_View = V * spiderWorldTransform * abdomenLocalToParent;
-        abdomen.draw(modelViewLoc, projectionLoc, modelAbdomen_View, projMatrix);
-
-        vec3 localHeadPos = cephalothorax.getHeadAnchorPoint();
-        mat4 headLocalToCeph = Angel::Translate(localHeadPos);
-        mat4 modelHead_World = spiderWorldTransform * headLocalToCeph;
-        mat4 modelHead_View = V * modelHead_World;
-        head.draw(modelViewLoc, projectionLoc, modelHead_View, projMatrix);
-
-        vec3 headAnchor = head.getMostFrontVertex();
-        float scaleFactor = ABDOMEN_RADIUS*HEAD_SCALE / (DEFAULT_ABDOMEN_RADIUS*0.5);
-        vec3 leftOffset  = vec3(-0.07f*scaleFactor, +0.05f*scaleFactor, 0.1f*scaleFactor);
-        vec3 rightOffset = vec3(+0.07f*scaleFactor, +0.05f*scaleFactor, 0.1f*scaleFactor);
-        float zElongation = 1.2f;
-
-        mat4 modelLeftEye_View  = V * modelHead_World * Angel::Translate(headAnchor + leftOffset)*Angel::Scale(1.0f, 1.0f, zElongation);
-        mat4 modelRightEye_View = V * modelHead_World * Angel::Translate(headAnchor + rightOffset)*Angel::Scale(1.0f, 1.0f, zElongation);
-        leftEye.draw(modelViewLoc, projectionLoc, modelLeftEye_View, projMatrix);
-        rightEye.draw(modelViewLoc, projectionLoc, modelRightEye_View, projMatrix);
-
-        vec3 leftOffset2  = vec3(-0.15f*scaleFactor, -0.15f*scaleFactor, 0.1f*scaleFactor);
-        vec3 rightOffset2 = vec3(+0.15f*scaleFactor, -0.15f*scaleFactor, 0.1f*scaleFactor);
-        mat4 modelLeftEye2_View = V * modelHead_World * Angel::Translate(headAnchor + leftOffset2) * Angel::Scale(0.7f, zElongation*0.7f, 0.7f);
-        mat4 modelRightEye2_View = V * modelHead_World * Angel::Translate(headAnchor + rightOffset2) * Angel::Scale(0.7f, zElongation*0.7f, 0.7f);
-        leftEye2.draw(modelViewLoc, projectionLoc, modelLeftEye2_View, projMatrix);
-        rightEye2.draw(modelViewLoc, projectionLoc, modelRightEye2_View, projMatrix);
-
-    std::vector<vec3> legAttachPoints = cephalothorax.getLegAttachmentPoints();
-
-    // Leg swing is always calculated based on leg_animation_cycle_
-    // which pauses if spider is not active
-    float swing_phase_rad = leg_animation_cycle_ * 1.0f * static_cast<float>(M_PI);
-    float current_swing_angle_deg = sin(swing_phase_rad) * max_leg_swing_angle_;
-
-    float legRotationGroup1 = current_swing_angle_deg;
-    float legRotationGroup2 = -current_swing_angle_deg;
-
-    if (legAttachPoints.size() >= 8) {
-        Leg* leg_objects[8] = {&leg, &leg2, &leg3, &leg4, &leg5, &leg6, &leg7, &leg8};
-        float leg_anim_rotations[8] = {
-            legRotationGroup1, legRotationGroup2, legRotationGroup2, legRotationGroup1,
-            legRotationGroup1, legRotationGroup2, legRotationGroup2, legRotationGroup1
-        };
-        bool scale_x_negatively[8] = { true, false, true, false, true, false, true, false };
-
-        mat4 legModelViewMatrix;
-
-        for(int i=0; i<8; ++i) {
-            mat4 leg_attachment_transform = Angel::Translate(legAttachPoints[i]);
-            mat4 leg_animation_rotation_transform = Angel::RotateY(leg_anim_rotations[i]);
-            mat4 leg_scale_transform = mat4();
-            if (scale_x_negatively[i]) {
-                leg_scale_transform = Angel::Scale(-1.0f, 1.0f, 1.0f);
-            }
-            mat4 leg_world_root_animated = spiderWorldTransform * leg_attachment_transform * leg_animation_rotation_transform * leg_scale_transform;
-            legModelViewMatrix = V * leg_world_root_animated;
-            leg_objects[i]->draw(modelViewLoc, projectionLoc,  legModelViewMatrix, projMatrix);
-        }
-    }
-    }
-
-    void Spider::drawAllComponents(
-    GLuint cephMVLoc, GLuint cephPLoc,
-    GLuint abdMVLoc, GLuint abdPLoc,
-    GLuint legMVLoc, GLuint legPLoc,
-    GLuint eyeMVLoc, GLuint eyePLoc,
-    const mat4& viewMatrix,
-    const mat4& projMatrix
-) {
-    mat4 R_yaw = Angel::RotateY(current_yaw_angle_);
-    mat4 T_translation = Angel::Translate(position);
-    mat4 S_scale = Angel::Scale(scale_, scale_, scale_);
-    mat4 spiderWorldTransform = T_translation * R_yaw * S_scale;
-    mat4 V = viewMatrix;
-
-    mat4 modelCT_View = V * spiderWorldTransform;
-    cephalothorax.draw(cephMVLoc, cephPLoc, modelCT_View, projMatrix);
-
-    const float rz_abdomen = ABDOMEN_RADIUS * ABDOMEN_SCALE_Z;
-    float current_abdomen_tilt = base_abdomen_tilt_angle_;
-    float shake_offset = sin(abdomen_shake_cycle_ * 2.0f * static_cast<float>(M_PI)) * max_abdomen_shake_amplitude_;
-    current_abdomen_tilt += shake_offset;
-
-    mat4 R_tilt_ab = Angel::RotateX(current_abdomen_tilt);
-    mat4 T_pivot_ab = Angel::Translate(0, 0, -rz_abdomen*1.8f);
-    mat4 abdomenLocalToParent = R_tilt_ab * T_pivot_ab;
-    mat4 modelAbdomen_View = V * spiderWorldTransform * abdomenLocalToParent;
-    abdomen.draw(abdMVLoc, abdPLoc, modelAbdomen_View, projMatrix);
-
-    vec3 localHeadPos = cephalothorax.getHeadAnchorPoint();
-    mat4 headLocalToCeph = Angel::Translate(localHeadPos);
-    mat4 modelHead_World = spiderWorldTransform * headLocalToCeph;
-    mat4 modelHead_View = V * modelHead_World;
-    head.draw(cephMVLoc, cephPLoc, modelHead_View, projMatrix);
-
-    vec3 headAnchor = head.getMostFrontVertex();
-    float scaleFactor = ABDOMEN_RADIUS*HEAD_SCALE / (DEFAULT_ABDOMEN_RADIUS*0.5);
-    vec3 leftOffset = vec3(-0.07f*scaleFactor, +0.05f*scaleFactor, 0.1f*scaleFactor);
-    vec3 rightOffset = vec3(+0.07f*scaleFactor, +0.05f*scaleFactor, 0.1f*scaleFactor);
-    float zElongation = 1.2f;
-
-    mat4 modelLeftEye_View = V * modelHead_World * Angel::Translate(headAnchor + leftOffset)*Angel::Scale(1.0f, 1.0f, zElongation);
-    mat4 modelRightEye_View = V * modelHead_World * Angel::Translate(headAnchor + rightOffset)*Angel::Scale(1.0f, 1.0f, zElongation);
-    leftEye.draw(eyeMVLoc, eyePLoc, modelLeftEye_View, projMatrix);
-    rightEye.draw(eyeMVLoc, eyePLoc, modelRightEye_View, projMatrix);
-
-    vec3 leftOffset2 = vec3(-0.15f*scaleFactor, -0.15f*scaleFactor, 0.1f*scaleFactor);
-    vec3 rightOffset2 = vec3(+0.15f*scaleFactor, -0.15f*scaleFactor, 0.1f*scaleFactor);
-    mat4 modelLeftEye2_View = V * modelHead_World * Angel::Translate(headAnchor + leftOffset2) * Angel::Scale(0.7f, zElongation*0.7f, 0.7f);
-    mat4 modelRightEye2_View = V * modelHead_World * Angel::Translate(headAnchor + rightOffset2) * Angel::Scale(0.7f, zElongation*0.7f, 0.7f);
-    leftEye2.draw(eyeMVLoc, eyePLoc, modelLeftEye2_View, projMatrix);
-    rightEye2.draw(eyeMVLoc, eyePLoc, modelRightEye2_View, projMatrix);
-
-    std::vector<vec3> legAttachPoints = cephalothorax.getLegAttachmentPoints();
-
-    float swing_phase_rad = leg_animation_cycle_ * 2.0f * static_cast<float>(M_PI);
-    float current_swing_angle_deg = sin(swing_phase_rad) * max_leg_swing_angle_;
-
-    float legRotationGroup1 = current_swing_angle_deg;
-    float legRotationGroup2 = -current_swing_angle_deg;
-
-    if (legAttachPoints.size() >= 8) {
-        Leg* leg_objects[8] = {&leg, &leg2, &leg3, &leg4, &leg5, &leg6, &leg7, &leg8};
-        float leg_anim_rotations[8] = {
-            legRotationGroup1, legRotationGroup2, legRotationGroup2, legRotationGroup1,
-            legRotationGroup1, legRotationGroup2, legRotationGroup2, legRotationGroup1
-        };
-        bool scale_x_negatively[8] = { true, false, true, false, true, false, true, false };
-
-        for(int i=0; i<8; ++i) {
-            mat4 leg_attachment_transform = Angel::Translate(legAttachPoints[i]);
-            mat4 leg_animation_rotation_transform = Angel::RotateY(leg_anim_rotations[i]);
-            mat4 leg_scale_transform = mat4();
-            if (scale_x_negatively[i]) {
-                leg_scale_transform = Angel::Scale(-1.0f, 1.0f, 1.0f);
-            }
-            mat4 leg_world_root_animated = spiderWorldTransform * leg_attachment_transform * leg_animation_rotation_transform * leg_scale_transform;
-            mat4 legModelViewMatrix = V * leg_world_root_animated;
-            leg_objects[i]->draw(legMVLoc, legPLoc, legModelViewMatrix, projMatrix);
-        }
-    }
-}
 } // namespace spider
 // --- End of Spider.cpp ---
@@ -0,0 +1,403 @@
+// Description: Source file for the SpiderRenderer class, drawing spiders from their simulation state.
+#include "spider/SpiderRenderer.h"
+#include "global/GlobalConfig.h"
+#include "utils/DrawStats.h"
+#include "utils/RenderQueue.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <cmath> // For M_PI, sin
+
+
+namespace spider {
+
+namespace {
+    // Legs 3, 4, 7 and 8 use the thicker segments
+    const float LEG_THICKNESS[LEG_COUNT] = {1.3f, 1.3f, 1.5f, 1.5f, 1.3f, 1.3f, 1.5f, 1.5f};
+    // Diagonal pairs swing together; the left legs are mirrored copies
+    const float LEG_SWING_SIGN[LEG_COUNT] = {1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f};
+    const float LEG_MIRROR_X[LEG_COUNT] = {-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f};
+
+    // Texels per spider in the GPU leg buffer: body, swing, then the joint angles four to a texel
+    const int GPU_LEG_TEXELS_PER_SPIDER = 2 + (LEG_COUNT * LEG_SEGMENT_COUNT + 3) / 4;
+    const int GPU_LEG_FLOATS_PER_SPIDER = 4 * GPU_LEG_TEXELS_PER_SPIDER;
+
+    // leg_fk_vertex.glsl declares its per-leg tables with eight entries
+    static_assert(LEG_COUNT == 8, "leg_fk_vertex.glsl assumes eight legs");
+}
+
+    SpiderRenderer::SpiderRenderer(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader)
+    : cephalothorax(cephalothoraxShader),
+      abdomen(abdomenShader),
+      head(cephalothoraxShader),
+      leftEye(eyeShader),
+      rightEye(eyeShader),
+      leftEye2(eyeShader),
+      rightEye2(eyeShader),
+      instancingEnabled_(false),
+      gpuLegsActive_(false) {
+
+        legs.reserve(LEG_COUNT);
+        for (int i = 0; i < LEG_COUNT; ++i) {
+            legs.emplace_back(legShader, LEG_SEGMENT_COUNT, LEG_SEGMENT_LENGTH, LEG_THICKNESS[i]);
+        }
+
+        const GLuint partPrograms[INSTANCED_PART_COUNT] = {
+            cephalothoraxShader, abdomenShader, cephalothoraxShader, eyeShader, legShader
+        };
+        for (int lod = 0; lod < MESH_LOD_COUNT; ++lod) {
+            queued_[INSTANCED_CEPHALOTHORAX][lod].mesh = cephalothorax.getMesh(lod);
+            queued_[INSTANCED_ABDOMEN][lod].mesh = abdomen.getMesh(lod);
+            queued_[INSTANCED_HEAD][lod].mesh = head.getMesh(lod);
+            queued_[INSTANCED_EYE][lod].mesh = leftEye.getMesh(lod);
+            // Distant legs use fewer segments, not a coarser cuboid
+            queued_[INSTANCED_LEG_SEGMENT][lod].mesh = LegSegment::getSharedMesh();
+            for (int part = 0; part < INSTANCED_PART_COUNT; ++part) {
+                queued_[part][lod].program = partPrograms[part];
+                queued_[part][lod].modelLoc = glGetUniformLocation(partPrograms[part], "model");
+            }
+        }
+    }
+
+    void SpiderRenderer::computePartTransforms(const SpiderState& state, PartTransforms& out, float legSwingCycles) {
+    mat4 R_yaw = Angel::RotateY(state.yaw);
+    mat4 T_translation = Angel::Translate(state.position);
+    mat4 S_scale = Angel::Scale(state.scale, state.scale, state.scale);
+    mat4 spiderWorldTransform = T_translation * R_yaw * S_scale;
+
+    out.cephalothorax = spiderWorldTransform;
+
+    const float rz_abdomen = ABDOMEN_RADIUS * ABDOMEN_SCALE_Z;
+    float current_abdomen_tilt = ABDOMEN_TILT_ANGLE;
+    float shake_offset = sin(state.abdomenShakeCycle * 2.0f * static_cast<float>(M_PI)) * ABDOMEN_MAX_SHAKE_AMPLITUDE;
+    current_abdomen_tilt += shake_offset;
+
+    mat4 R_tilt_ab = Angel::RotateX(current_abdomen_tilt);
+    mat4 T_pivot_ab = Angel::Translate(0, 0, -rz_abdomen*1.8f);
+    mat4 abdomenLocalToParent = R_tilt_ab * T_pivot_ab;
+    out.abdomen = spiderWorldTransform * abdomenLocalToParent;
+
+    const SpiderRig& rig = Cephalothorax::getRig();
+    mat4 headLocalToCeph = Angel::Translate(rig.headAnchor);
+    mat4 modelHead_World = spiderWorldTransform * headLocalToCeph;
+    out.head = modelHead_World;
+
+    const vec3& headAnchor = rig.eyeAnchor;
+    float scaleFactor = ABDOMEN_RADIUS*HEAD_SCALE / (DEFAULT_ABDOMEN_RADIUS*0.5);
+    vec3 leftOffset = vec3(-0.07f*scaleFactor, +0.05f*scaleFactor, 0.1f*scaleFactor);
+    vec3 rightOffset = vec3(+0.07f*scaleFactor, +0.05f*scaleFactor, 0.1f*scaleFactor);
+    float zElongation = 1.2f;
+    out.eyes[0] = modelHead_World * Angel::Translate(headAnchor + leftOffset)*Angel::Scale(1.0f, 1.0f, zElongation);
+    out.eyes[1] = modelHead_World * Angel::Translate(headAnchor + rightOffset)*Angel::Scale(1.0f, 1.0f, zElongation);
+
+    vec3 leftOffset2 = vec3(-0.15f*scaleFactor, -0.15f*scaleFactor, 0.1f*scaleFactor);
+    vec3 rightOffset2 = vec3(+0.15f*scaleFactor, -0.15f*scaleFactor, 0.1f*scaleFactor);
+    out.eyes[2] = modelHead_World * Angel::Translate(headAnchor + leftOffset2) * Angel::Scale(0.7f, zElongation*0.7f, 0.7f);
+    out.eyes[3] = modelHead_World * Angel::Translate(headAnchor + rightOffset2) * Angel::Scale(0.7f, zElongation*0.7f, 0.7f);
+
+    const std::array<vec3, LEG_COUNT>& legAttachPoints = rig.legAttachments;
+
+    float current_swing_angle_deg = legSwingAngle(state, legSwingCycles);
+
+    for(int i=0; i<LEG_COUNT; ++i) {
+        mat4 leg_attachment_transform = Angel::Translate(legAttachPoints[i]);
+        mat4 leg_animation_rotation_transform = Angel::RotateY(LEG_SWING_SIGN[i] * current_swing_angle_deg);
+        mat4 leg_scale_transform = Angel::Scale(LEG_MIRROR_X[i], 1.0f, 1.0f);
+        out.legRoots[i] = spiderWorldTransform * leg_attachment_transform * leg_animation_rotation_transform * leg_scale_transform;
+    }
+}
+
+    float SpiderRenderer::legSwingAngle(const SpiderState& state, float legSwingCycles) {
+    float swing_phase_rad = state.legAnimationCycle * legSwingCycles * 2.0f * static_cast<float>(M_PI);
+    return sin(swing_phase_rad) * LEG_MAX_SWING_ANGLE;
+}
+
+    bool SpiderRenderer::isVisible(const SpiderState& state, const ViewFrustum& frustum) {
+    return frustum.intersectsSphere(state.position, Cephalothorax::getRig().boundingRadius * state.scale);
+}
+
+    int SpiderRenderer::selectLod(float screenRadius, int previousLod) {
+    int lod = std::max(0, std::min(previousLod, MESH_LOD_COUNT - 1));
+    // Coarser only once clearly below a threshold, finer only once clearly above it
+    while (lod < MESH_LOD_COUNT - 1 && screenRadius < LOD_SCREEN_RADIUS[lod] * (1.0f - LOD_HYSTERESIS)) {
+        ++lod;
+    }
+    while (lod > 0 && screenRadius > LOD_SCREEN_RADIUS[lod - 1] * (1.0f + LOD_HYSTERESIS)) {
+        --lod;
+    }
+    return lod;
+}
+
+    void SpiderRenderer::selectVisible(const std::vector<SpiderState>& states, const ViewFrustum& frustum,
+                                       const mat4& viewMatrix, const mat4& projMatrix, float viewportHeight,
+                                       std::vector<SpiderState>& visible, std::vector<int>& lods) {
+    PROFILE_SCOPE("SpiderRenderer::selectVisible");
+    visible.clear();
+    lods.clear();
+    lodHistory_.resize(states.size(), 0);
+
+    // projMatrix[1][1] is cot(fovy / 2): a radius r at view depth d covers
+    // r * cot / d of the half-height of the viewport
+    const float pixelsPerUnitAtDepth1 = projMatrix[1][1] * viewportHeight * 0.5f;
+    const float rigRadius = Cephalothorax::getRig().boundingRadius;
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        const SpiderState& state = states[i];
+        if (!isVisible(state, frustum)) {
+            continue;
+        }
+        vec4 viewPos = viewMatrix * vec4(state.position, 1.0f);
+        float depth = -viewPos.z;
+        float screenRadius = depth > 0.0f ? rigRadius * state.scale * pixelsPerUnitAtDepth1 / depth
+                                          : LOD_SCREEN_RADIUS[0] * 2.0f;
+        int lod = selectLod(screenRadius, lodHistory_[i]);
+        lodHistory_[i] = static_cast<uint8_t>(lod);
+
+        visible.push_back(state);
+        lods.push_back(lod);
+    }
+}
+
+    void SpiderRenderer::enqueue(const SpiderState& state, RenderQueue& queue, int lod, float legSwingCycles) {
+    PROFILE_SCOPE("SpiderRenderer::enqueue");
+    PartTransforms parts;
+    computePartTransforms(state, parts, legSwingCycles);
+
+    queuePart(queue, queued_[INSTANCED_CEPHALOTHORAX][lod], parts.cephalothorax);
+    queuePart(queue, queued_[INSTANCED_ABDOMEN][lod], parts.abdomen);
+    queuePart(queue, queued_[INSTANCED_HEAD][lod], parts.head);
+    for (const mat4& eye : parts.eyes) {
+        queuePart(queue, queued_[INSTANCED_EYE][lod], eye);
+    }
+
+    legTransforms_.clear();
+    for (int i = 0; i < LEG_COUNT; ++i) {
+        legs[i].appendSegmentTransforms(parts.legRoots[i], state.jointAngles[i], legTransforms_, LEG_LOD_JOINT_STRIDE[lod]);
+    }
+    for (const mat4& segment : legTransforms_) {
+        queuePart(queue, queued_[INSTANCED_LEG_SEGMENT][lod], segment);
+    }
+}
+
+    void SpiderRenderer::queuePart(RenderQueue& queue, const QueuedPart& part, const mat4& model) {
+    DrawPacket packet;
+    packet.program = part.program;
+    packet.vertexArray = part.mesh->vao.get();
+    packet.count = part.mesh->indexCount;
+    packet.modelLoc = part.modelLoc;
+    packet.model = model;
+    queue.push(packet);
+}
+
+    void SpiderRenderer::enableInstancing(GLuint cephalothoraxShader, GLuint abdomenShader, GLuint legShader, GLuint eyeShader) {
+    for (int lod = 0; lod < MESH_LOD_COUNT; ++lod) {
+        instanced_[INSTANCED_CEPHALOTHORAX][lod].mesh = cephalothorax.getMesh(lod);
+        instanced_[INSTANCED_CEPHALOTHORAX][lod].program = cephalothoraxShader;
+        instanced_[INSTANCED_ABDOMEN][lod].mesh = abdomen.getMesh(lod);
+        instanced_[INSTANCED_ABDOMEN][lod].program = abdomenShader;
+        instanced_[INSTANCED_HEAD][lod].mesh = head.getMesh(lod);
+        instanced_[INSTANCED_HEAD][lod].program = cephalothoraxShader;
+        instanced_[INSTANCED_EYE][lod].mesh = leftEye.getMesh(lod);
+        instanced_[INSTANCED_EYE][lod].program = eyeShader;
+    }
+    // Every level's leg segments are the same cuboid, so they share one batch
+    instanced_[INSTANCED_LEG_SEGMENT][0].mesh = LegSegment::getSharedMesh();
+    instanced_[INSTANCED_LEG_SEGMENT][0].program = legShader;
+
+    for (auto& levels : instanced_) {
+    for (InstancedBatch& batch : levels) {
+        if (!batch.mesh) {
+            continue;
+        }
+        batch.vao = GLVertexArray::create();
+        batch.instanceBuffer = GLBuffer::create();
+
+        glBindVertexArray(batch.vao.get());
+        bindMeshVertexLayout(*batch.mesh);
+
+        // Attributes 2..5 carry one row of the instance's model matrix each
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceBuffer.get());
+        for (GLuint row = 0; row < 4; ++row) {
+            glEnableVertexAttribArray(2 + row);
+            glVertexAttribPointer(2 + row, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*)(row * sizeof(vec4)));
+            glVertexAttribDivisor(2 + row, 1);
+        }
+        glBindVertexArray(0);
+    }
+    }
+    instancingEnabled_ = true;
+}
+
+    bool SpiderRenderer::isInstancingEnabled() const {
+    return instancingEnabled_;
+}
+
+    void SpiderRenderer::drawInstanced(const std::vector<SpiderState>& states, const std::vector<int>& lods) {
+    PROFILE_SCOPE("SpiderRenderer::drawInstanced");
+    if (!instancingEnabled_) {
+        return;
+    }
+    for (auto& levels : instanced_) {
+        for (InstancedBatch& batch : levels) {
+            batch.transforms.clear();
+        }
+    }
+    if (!gpuLegsActive_) {
+        instanced_[INSTANCED_LEG_SEGMENT][0].transforms.reserve(states.size() * LEG_COUNT * LEG_SEGMENT_COUNT);
+    }
+
+    PartTransforms parts;
+    for (size_t s = 0; s < states.size(); ++s) {
+        const SpiderState& state = states[s];
+        const int lod = lods[s];
+        computePartTransforms(state, parts);
+        instanced_[INSTANCED_CEPHALOTHORAX][lod].transforms.push_back(parts.cephalothorax);
+        instanced_[INSTANCED_ABDOMEN][lod].transforms.push_back(parts.abdomen);
+        instanced_[INSTANCED_HEAD][lod].transforms.push_back(parts.head);
+        std::vector<mat4>& eyes = instanced_[INSTANCED_EYE][lod].transforms;
+        eyes.insert(eyes.end(), parts.eyes, parts.eyes + 4);
+        if (gpuLegsActive_) {
+            continue;
+        }
+        for (int i = 0; i < LEG_COUNT; ++i) {
+            legs[i].appendSegmentTransforms(parts.legRoots[i], state.jointAngles[i],
+                                            instanced_[INSTANCED_LEG_SEGMENT][0].transforms, LEG_LOD_JOINT_STRIDE[lod]);
+        }
+    }
+
+    for (auto& levels : instanced_) {
+        for (InstancedBatch& batch : levels) {
+            flushInstanced(batch);
+        }
+    }
+    if (gpuLegsActive_) {
+        drawGpuLegs(states, lods);
+    }
+}
+
+    void SpiderRenderer::enableGpuLegs(GLuint legFKShader) {
+    gpuLegs_.program = legFKShader;
+    gpuLegs_.dataLoc = glGetUniformLocation(legFKShader, "spiderLegData");
+    gpuLegs_.firstSpiderLoc = glGetUniformLocation(legFKShader, "firstSpider");
+    gpuLegs_.jointStrideLoc = glGetUniformLocation(legFKShader, "jointStride");
+
+    // Everything that is the same for every spider is set once
+    const SpiderRig& rig = Cephalothorax::getRig();
+    glUseProgram(legFKShader);
+    glUniform1i(glGetUniformLocation(legFKShader, "texelsPerSpider"), GPU_LEG_TEXELS_PER_SPIDER);
+    glUniform1i(glGetUniformLocation(legFKShader, "segmentCount"), LEG_SEGMENT_COUNT);
+    glUniform1f(glGetUniformLocation(legFKShader, "segmentLength"), LEG_SEGMENT_LENGTH);
+    glUniform3fv(glGetUniformLocation(legFKShader, "legAttachments"), LEG_COUNT, static_cast<const GLfloat*>(rig.legAttachments[0]));
+    glUniform1fv(glGetUniformLocation(legFKShader, "legSwingSign"), LEG_COUNT, LEG_SWING_SIGN);
+    glUniform1fv(glGetUniformLocation(legFKShader, "legMirrorX"), LEG_COUNT, LEG_MIRROR_X);
+    glUniform1fv(glGetUniformLocation(legFKShader, "legThickness"), LEG_COUNT, LEG_THICKNESS);
+
+    // Only the segment cuboid is a vertex input; the instance data is fetched by index
+    gpuLegs_.vao = GLVertexArray::create();
+    glBindVertexArray(gpuLegs_.vao.get());
+    bindMeshVertexLayout(*LegSegment::getSharedMesh());
+    glBindVertexArray(0);
+
+    gpuLegs_.dataBuffer = GLBuffer::create();
+    glBindBuffer(GL_TEXTURE_BUFFER, gpuLegs_.dataBuffer.get());
+    glBufferData(GL_TEXTURE_BUFFER, GPU_LEG_FLOATS_PER_SPIDER * sizeof(GLfloat), nullptr, GL_STREAM_DRAW);
+    gpuLegs_.dataTexture = GLTexture::create();
+    glBindTexture(GL_TEXTURE_BUFFER, gpuLegs_.dataTexture.get());
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, gpuLegs_.dataBuffer.get());
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    gpuLegsActive_ = true;
+}
+
+    void SpiderRenderer::setGpuLegsActive(bool active) {
+    gpuLegsActive_ = active && gpuLegs_.program != 0;
+}
+
+    bool SpiderRenderer::isGpuLegsActive() const {
+    return gpuLegsActive_;
+}
+
+    void SpiderRenderer::drawGpuLegs(const std::vector<SpiderState>& states, const std::vector<int>& lods) {
+    PROFILE_SCOPE("SpiderRenderer::drawGpuLegs");
+    if (states.empty()) {
+        return;
+    }
+    // Records are grouped by joint stride so each group is one contiguous draw
+    gpuLegs_.order.clear();
+    size_t groupEnd[MESH_LOD_COUNT] = {};
+    for (int lod = 0; lod < MESH_LOD_COUNT; ++lod) {
+        for (size_t s = 0; s < states.size(); ++s) {
+            if (lods[s] == lod) {
+                gpuLegs_.order.push_back(s);
+            }
+        }
+        groupEnd[lod] = gpuLegs_.order.size();
+    }
+
+    gpuLegs_.records.assign(states.size() * GPU_LEG_FLOATS_PER_SPIDER, 0.0f);
+    for (size_t slot = 0; slot < gpuLegs_.order.size(); ++slot) {
+        const SpiderState& state = states[gpuLegs_.order[slot]];
+        GLfloat* record = &gpuLegs_.records[slot * GPU_LEG_FLOATS_PER_SPIDER];
+        record[0] = state.position.x;
+        record[1] = state.position.y;
+        record[2] = state.position.z;
+        record[3] = state.yaw;
+        record[4] = state.scale;
+        record[5] = legSwingAngle(state);
+        GLfloat* angles = record + 8;
+        for (int leg = 0; leg < LEG_COUNT; ++leg) {
+            std::copy(state.jointAngles[leg], state.jointAngles[leg] + LEG_SEGMENT_COUNT, angles + leg * LEG_SEGMENT_COUNT);
+        }
+    }
+
+    // Orphan and refill, like the instance buffers; the texture keeps pointing at the buffer
+    glBindBuffer(GL_TEXTURE_BUFFER, gpuLegs_.dataBuffer.get());
+    glBufferData(GL_TEXTURE_BUFFER, gpuLegs_.records.size() * sizeof(GLfloat), &gpuLegs_.records[0], GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glUseProgram(gpuLegs_.program);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, gpuLegs_.dataTexture.get());
+    glUniform1i(gpuLegs_.dataLoc, 0);
+
+    const GLsizei indexCount = LegSegment::getSharedMesh()->indexCount;
+    glBindVertexArray(gpuLegs_.vao.get());
+    size_t groupBegin = 0;
+    for (int lod = 0; lod < MESH_LOD_COUNT; ++lod) {
+        const size_t spiders = groupEnd[lod] - groupBegin;
+        if (spiders > 0) {
+            const int stride = LEG_LOD_JOINT_STRIDE[lod];
+            const size_t segmentsPerLeg = (LEG_SEGMENT_COUNT + stride - 1) / stride;
+            const size_t instances = spiders * LEG_COUNT * segmentsPerLeg;
+            glUniform1i(gpuLegs_.firstSpiderLoc, static_cast<GLint>(groupBegin));
+            glUniform1i(gpuLegs_.jointStrideLoc, stride);
+            glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(instances));
+            recordDrawCall(instances, indexCount / 3);
+        }
+        groupBegin = groupEnd[lod];
+    }
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+    // Instance buffers are filled straight from std::vector<mat4>
+    static_assert(sizeof(mat4) == 16 * sizeof(GLfloat), "mat4 must be 16 tightly packed floats");
+
+    void SpiderRenderer::flushInstanced(InstancedBatch& batch) {
+    if (batch.transforms.empty()) {
+        return;
+    }
+    // Orphan and refill: the previous frame's data may still be in flight
+    glBindBuffer(GL_ARRAY_BUFFER, batch.instanceBuffer.get());
+    glBufferData(GL_ARRAY_BUFFER, batch.transforms.size() * sizeof(mat4), &batch.transforms[0], GL_STREAM_DRAW);
+
+    glUseProgram(batch.program);
+
+    const GLsizei count = static_cast<GLsizei>(batch.transforms.size());
+    glBindVertexArray(batch.vao.get());
+    glDrawElementsInstanced(GL_TRIANGLES, batch.mesh->indexCount, GL_UNSIGNED_INT, nullptr, count);
+    glBindVertexArray(0);
+    recordDrawCall(batch.transforms.size(), batch.mesh->indexCount / 3);
+}
+} // namespace spider
+// --- End of SpiderRenderer.cpp ---
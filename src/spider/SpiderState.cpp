@@ -0,0 +1,60 @@
+// Description: Source file for blending spider states between simulation ticks.
+#include "spider/SpiderState.h"
+#include <cmath>
+
+namespace spider {
+
+namespace {
+    // Leg cycles wrap over (-1, 1], abdomen cycles over (0, 1]
+    const float LEG_CYCLE_PERIOD = 2.0f;
+    const float SHAKE_CYCLE_PERIOD = 1.0f;
+    const float YAW_PERIOD = 360.0f;
+
+    float lerp(float a, float b, float t) {
+        return a + (b - a) * t;
+    }
+
+    // Shortest step from a to b on a circle of the given period
+    float lerpWrapped(float a, float b, float t, float period) {
+        float delta = b - a;
+        delta -= period * std::floor(delta / period + 0.5f);
+        return a + delta * t;
+    }
+}
+
+SpiderState interpolate(const SpiderState& previous, const SpiderState& current, float alpha) {
+    vec3 moved = current.position - previous.position;
+    if (dot(moved, moved) > INTERPOLATION_SNAP_DISTANCE * INTERPOLATION_SNAP_DISTANCE) {
+        return current;
+    }
+
+    SpiderState out = current;
+    out.position = previous.position + moved * alpha;
+    out.yaw = lerpWrapped(previous.yaw, current.yaw, alpha, YAW_PERIOD);
+    float yawRad = out.yaw * static_cast<float>(M_PI) / 180.0f;
+    out.forward = vec3(std::sin(yawRad), 0.0f, std::cos(yawRad));
+    out.scale = lerp(previous.scale, current.scale, alpha);
+    out.legAnimationCycle = lerpWrapped(previous.legAnimationCycle, current.legAnimationCycle, alpha, LEG_CYCLE_PERIOD);
+    out.abdomenShakeCycle = lerpWrapped(previous.abdomenShakeCycle, current.abdomenShakeCycle, alpha, SHAKE_CYCLE_PERIOD);
+    out.jumpTime = lerp(previous.jumpTime, current.jumpTime, alpha);
+    for (int leg = 0; leg < LEG_COUNT; ++leg) {
+        for (int joint = 0; joint < LEG_SEGMENT_COUNT; ++joint) {
+            out.jointAngles[leg][joint] = lerp(previous.jointAngles[leg][joint], current.jointAngles[leg][joint], alpha);
+        }
+    }
+    return out;
+}
+
+void interpolateStates(const std::vector<SpiderState>& previous, const std::vector<SpiderState>& current,
+                       float alpha, std::vector<SpiderState>& out) {
+    out.resize(current.size());
+    const size_t blended = previous.size() < current.size() ? previous.size() : current.size();
+    for (size_t i = 0; i < blended; ++i) {
+        out[i] = interpolate(previous[i], current[i], alpha);
+    }
+    for (size_t i = blended; i < current.size(); ++i) {
+        out[i] = current[i];
+    }
+}
+
+} // namespace spider
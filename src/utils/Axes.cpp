@@ -128,10 +128,9 @@ Axes::~Axes() {
     glDeleteBuffers(1, &_ebo);
 }
 
-void Axes::draw(GLuint modelViewLoc, GLuint projectionLoc, const mat4& MV, const mat4& P) const {
+void Axes::draw(GLuint modelLoc, const mat4& M) const {
     glUseProgram(_program);
-    glUniformMatrix4fv(modelViewLoc, 1, GL_TRUE, MV);
-    glUniformMatrix4fv(projectionLoc, 1, GL_TRUE, P);
+    glUniformMatrix4fv(modelLoc, 1, GL_TRUE, M);
 
     glBindVertexArray(_vao);
     glDrawElements(GL_TRIANGLES, _indexCount, GL_UNSIGNED_INT, nullptr);
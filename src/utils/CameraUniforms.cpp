@@ -0,0 +1,35 @@
+// Description: Source file for the camera uniform buffer.
+#include "utils/CameraUniforms.h"
+#include <cstring>
+
+static_assert(sizeof(CameraBlock) == 3 * 16 * sizeof(GLfloat), "CameraBlock must match the std140 layout");
+static_assert(sizeof(mat4) == 16 * sizeof(GLfloat), "mat4 must be 16 tightly packed floats");
+
+CameraUniforms::CameraUniforms()
+    : buffer_(GLBuffer::create()) {
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_.get());
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, buffer_.get());
+}
+
+bool CameraUniforms::attach(GLuint program) {
+    GLuint block = glGetUniformBlockIndex(program, "Camera");
+    if (block == GL_INVALID_INDEX) {
+        return false;
+    }
+    glUniformBlockBinding(program, block, BINDING);
+    return true;
+}
+
+void CameraUniforms::update(const mat4& view, const mat4& projection) {
+    CameraBlock block;
+    mat4 viewProjection = projection * view;
+    std::memcpy(block.view, static_cast<const GLfloat*>(view), sizeof(block.view));
+    std::memcpy(block.projection, static_cast<const GLfloat*>(projection), sizeof(block.projection));
+    std::memcpy(block.viewProjection, static_cast<const GLfloat*>(viewProjection), sizeof(block.viewProjection));
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer_.get());
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
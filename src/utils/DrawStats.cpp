@@ -0,0 +1,29 @@
+// Description: Source file for the draw call counters.
+#include "utils/DrawStats.h"
+
+namespace {
+    DrawStats g_drawStats = {0, 0, 0, 0, 0};
+}
+
+void recordDrawCall(size_t instances, size_t trianglesPerInstance) {
+    ++g_drawStats.drawCalls;
+    g_drawStats.instances += instances;
+    g_drawStats.triangles += instances * trianglesPerInstance;
+}
+
+void recordCulling(size_t visible, size_t culled) {
+    g_drawStats.visible += visible;
+    g_drawStats.culled += culled;
+}
+
+DrawStats getDrawStats() {
+    return g_drawStats;
+}
+
+void resetDrawStats() {
+    g_drawStats.drawCalls = 0;
+    g_drawStats.instances = 0;
+    g_drawStats.triangles = 0;
+    g_drawStats.visible = 0;
+    g_drawStats.culled = 0;
+}
@@ -0,0 +1,110 @@
+// Description: Source file for per-pass GPU timing.
+#include "utils/GpuTimer.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // Sorted samples, rank in 0..1
+    float percentile(const std::vector<float>& sorted, float rank) {
+        size_t index = static_cast<size_t>(rank * (sorted.size() - 1) + 0.5f);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+GpuTimer::GpuTimer()
+    : supported_(false), slot_(0), recorded_(0), dropped_(0) {
+    std::fill(&issued_[0], &issued_[0] + FRAMES_IN_FLIGHT, false);
+    std::fill(&queries_[0][0], &queries_[0][0] + FRAMES_IN_FLIGHT * QUERIES_PER_FRAME, 0u);
+
+    // Timer queries are core in 3.3; software rasterizers such as llvmpipe
+    // implement them too, but a zero-bit counter means timestamps are meaningless
+    if (!GLEW_VERSION_3_3 && !GLEW_ARB_timer_query) {
+        return;
+    }
+    GLint counterBits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits);
+    if (counterBits == 0) {
+        return;
+    }
+    glGenQueries(FRAMES_IN_FLIGHT * QUERIES_PER_FRAME, &queries_[0][0]);
+    supported_ = true;
+}
+
+GpuTimer::~GpuTimer() {
+    if (supported_) {
+        glDeleteQueries(FRAMES_IN_FLIGHT * QUERIES_PER_FRAME, &queries_[0][0]);
+    }
+}
+
+bool GpuTimer::isSupported() const {
+    return supported_;
+}
+
+void GpuTimer::beginFrame() {
+    if (!supported_) {
+        return;
+    }
+    slot_ = (slot_ + 1) % FRAMES_IN_FLIGHT;
+    if (issued_[slot_]) {
+        collect(slot_);
+    }
+    glQueryCounter(queries_[slot_][0], GL_TIMESTAMP);
+    issued_[slot_] = true;
+}
+
+void GpuTimer::endPass(GpuPass pass) {
+    if (!supported_) {
+        return;
+    }
+    glQueryCounter(queries_[slot_][pass + 1], GL_TIMESTAMP);
+}
+
+void GpuTimer::collect(int slot) {
+    // Results arrive in order, so the last query being ready means they all are
+    GLint available = 0;
+    glGetQueryObjectiv(queries_[slot][QUERIES_PER_FRAME - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++dropped_;
+        return;
+    }
+
+    GLuint64 timestamps[QUERIES_PER_FRAME];
+    for (int i = 0; i < QUERIES_PER_FRAME; ++i) {
+        glGetQueryObjectui64v(queries_[slot][i], GL_QUERY_RESULT, &timestamps[i]);
+    }
+    const size_t index = recorded_ % HISTORY;
+    for (int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+        history_[pass][index] = static_cast<float>(timestamps[pass + 1] - timestamps[pass]) * 1e-6f;
+    }
+    ++recorded_;
+}
+
+GpuPassStats GpuTimer::getStats(GpuPass pass) const {
+    GpuPassStats stats = {0.0f, 0.0f, 0.0f, 0.0f, 0};
+    const size_t count = std::min<size_t>(recorded_, HISTORY);
+    if (count == 0) {
+        return stats;
+    }
+    std::vector<float> sorted(history_[pass], history_[pass] + count);
+    std::sort(sorted.begin(), sorted.end());
+
+    float sum = 0.0f;
+    for (float ms : sorted) {
+        sum += ms;
+    }
+    stats.average = sum / count;
+    stats.p50 = percentile(sorted, 0.50f);
+    stats.p95 = percentile(sorted, 0.95f);
+    stats.p99 = percentile(sorted, 0.99f);
+    stats.samples = count;
+    return stats;
+}
+
+size_t GpuTimer::getDroppedFrames() const {
+    return dropped_;
+}
+
+const char* GpuTimer::getPassName(GpuPass pass) {
+    static const char* const NAMES[GPU_PASS_COUNT] = {"obstacles", "AI spiders", "player", "ground", "overlay"};
+    return pass < GPU_PASS_COUNT ? NAMES[pass] : "unknown";
+}
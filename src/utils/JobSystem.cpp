@@ -0,0 +1,201 @@
+// JobSystem.cpp
+#include "utils/JobSystem.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+
+namespace {
+    // Which deque the current thread pushes to; 0 for threads the pool does not own
+    thread_local unsigned t_queueIndex = 0;
+}
+
+// ---- TaskGraph ----
+
+TaskGraph::TaskId TaskGraph::add(const char* name, std::function<void()> work) {
+    std::unique_ptr<Task> task(new Task());
+    task->name = name;
+    task->work = std::move(work);
+    task->remaining.store(0);
+    tasks_.push_back(std::move(task));
+    return tasks_.size() - 1;
+}
+
+void TaskGraph::precede(TaskId before, TaskId after) {
+    tasks_[before]->successors.push_back(after);
+    tasks_[after]->dependencyCount++;
+}
+
+size_t TaskGraph::size() const {
+    return tasks_.size();
+}
+
+const char* TaskGraph::getName(TaskId id) const {
+    return tasks_[id]->name;
+}
+
+void TaskGraph::clear() {
+    tasks_.clear();
+}
+
+// ---- JobSystem ----
+
+JobSystem::JobSystem(unsigned workerCount)
+    : stopping_(false), queued_(0) {
+    workerCount = std::max(1u, workerCount);
+    for (unsigned i = 0; i <= workerCount; ++i) {
+        queues_.emplace_back(new Queue());
+    }
+    threads_.reserve(workerCount);
+    for (unsigned i = 1; i <= workerCount; ++i) {
+        threads_.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    stopping_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+unsigned JobSystem::defaultWorkerCount() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 1;
+}
+
+unsigned JobSystem::getWorkerCount() const {
+    return static_cast<unsigned>(threads_.size());
+}
+
+void JobSystem::submit(Job job) {
+    Queue& queue = *queues_[t_queueIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+        queued_.fetch_add(1);
+    }
+    // Taking the sleep mutex orders this push against a worker that is about to wait
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+bool JobSystem::tryRunOne() {
+    const unsigned self = t_queueIndex;
+    const unsigned queueCount = static_cast<unsigned>(queues_.size());
+    Job job;
+    bool found = false;
+
+    // Own work first, newest job (still warm in cache)
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+
+    // Otherwise steal the oldest job of another queue
+    for (unsigned k = 1; !found && k < queueCount; ++k) {
+        Queue& victim = *queues_[(self + k) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    queued_.fetch_sub(1);
+    job.work();
+    job.pending->fetch_sub(1);
+    return true;
+}
+
+void JobSystem::wait(std::atomic<int>& pending) {
+    while (pending.load() > 0) {
+        if (!tryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(unsigned queueIndex) {
+    t_queueIndex = queueIndex;
+    PROFILE_THREAD_NAME("job worker");
+    while (!stopping_.load()) {
+        if (tryRunOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stopping_.load() || queued_.load() > 0; });
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(1, grainSize);
+    if (count <= grainSize) {
+        body(0, count);
+        return;
+    }
+
+    const size_t chunks = (count + grainSize - 1) / grainSize;
+    std::atomic<int> pending(static_cast<int>(chunks));
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        size_t begin = chunk * grainSize;
+        size_t end = std::min(count, begin + grainSize);
+        Job job;
+        job.work = [&body, begin, end] { body(begin, end); };
+        job.pending = &pending;
+        submit(std::move(job));
+    }
+    wait(pending);
+}
+
+void JobSystem::scheduleTask(TaskGraph& graph, TaskGraph::TaskId id, std::atomic<int>& pending) {
+    Job job;
+    job.work = [this, &graph, id, &pending] {
+        TaskGraph::Task& task = *graph.tasks_[id];
+        {
+            PROFILE_SCOPE(task.name);
+            task.work();
+        }
+        for (TaskGraph::TaskId next : task.successors) {
+            if (graph.tasks_[next]->remaining.fetch_sub(1) == 1) {
+                scheduleTask(graph, next, pending);
+            }
+        }
+    };
+    job.pending = &pending;
+    submit(std::move(job));
+}
+
+void JobSystem::run(TaskGraph& graph) {
+    if (graph.tasks_.empty()) {
+        return;
+    }
+
+    std::atomic<int> pending(static_cast<int>(graph.tasks_.size()));
+    for (auto& task : graph.tasks_) {
+        task->remaining.store(task->dependencyCount);
+    }
+    for (TaskGraph::TaskId id = 0; id < graph.tasks_.size(); ++id) {
+        if (graph.tasks_[id]->dependencyCount == 0) {
+            scheduleTask(graph, id, pending);
+        }
+    }
+    wait(pending);
+}
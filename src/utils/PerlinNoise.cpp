@@ -4,40 +4,264 @@
 // PerlinNoise.cpp is written by AI with GEMINI and ChatGPT
 
 #include "utils/PerlinNoise.h"
+#include "utils/SimdMath.h"
+#include <algorithm>
+#include <numeric>
 
+namespace {
+    // Simplex skew and unskew factors for three dimensions
+    const float F3 = 1.0f / 3.0f;
+    const float G3 = 1.0f / 6.0f;
+    // Squared radius of a simplex corner's influence. The paper's 0.6 lets corners reach
+    // past their neighbouring simplices, which leaves small jumps in value and gradient.
+    const float SIMPLEX_RADIUS2 = 0.5f;
+    // Brings the sum to about [-1, 1] (measured peak 0.94)
+    const float SIMPLEX_SCALE = 72.0f;
+
+    // The gradient grad() dots with: one of the 12 cube edge directions, picked by the low 4 hash bits
+    void gradientOf(int hash, float& gx, float& gy, float& gz) {
+        int h = hash & 15;
+        float u = (h & 1) == 0 ? 1.0f : -1.0f;
+        float v = (h & 2) == 0 ? 1.0f : -1.0f;
+        bool uIsX = h < 8;
+        bool vIsY = h < 4;
+        bool vIsX = h == 12 || h == 14;
+        gx = (uIsX ? u : 0.0f) + (vIsX ? v : 0.0f);
+        gy = (uIsX ? 0.0f : u) + (vIsY ? v : 0.0f);
+        gz = (vIsY || vIsX) ? 0.0f : v;
+    }
+
+    float fadeDerivative(float t) {
+        return 30.0f * t * t * (t - 1.0f) * (t - 1.0f);
+    }
+
+    // Maps a raw sample in [-1, 1] to [0, 1] like noise() does
+    NoiseSample toUnitRange(float value, float dx, float dy, float dz) {
+        NoiseSample sample = {0.5f * value + 0.5f, 0.5f * dx, 0.5f * dy, 0.5f * dz};
+        return sample;
+    }
+
+    // Trilinear blend written as a polynomial in the fade weights (so it can be
+    // differentiated): c000 + k1 u + k2 v + k3 w + k4 uv + k5 vw + k6 wu + k7 uvw
+    struct TrilinearTerms {
+        float k0, k1, k2, k3, k4, k5, k6, k7;
+    };
+
+    TrilinearTerms trilinearTerms(const float c[8]) {
+        // Corners indexed by x + 2y + 4z
+        TrilinearTerms k;
+        k.k0 = c[0];
+        k.k1 = c[1] - c[0];
+        k.k2 = c[2] - c[0];
+        k.k3 = c[4] - c[0];
+        k.k4 = c[0] - c[1] - c[2] + c[3];
+        k.k5 = c[0] - c[2] - c[4] + c[6];
+        k.k6 = c[0] - c[1] - c[4] + c[5];
+        k.k7 = -c[0] + c[1] + c[2] - c[3] + c[4] - c[5] - c[6] + c[7];
+        return k;
+    }
+
+    float blend(const TrilinearTerms& k, float u, float v, float w) {
+        return k.k0 + k.k1 * u + k.k2 * v + k.k3 * w + k.k4 * u * v + k.k5 * v * w + k.k6 * w * u + k.k7 * u * v * w;
+    }
+
+    // One simplex corner: its falloff times the gradient dot, and that term's gradient
+    void simplexCorner(int hash, float dx, float dy, float dz, float& value, float& gradX, float& gradY, float& gradZ) {
+        float t = SIMPLEX_RADIUS2 - dx * dx - dy * dy - dz * dz;
+        if (t <= 0.0f) {
+            return;
+        }
+        float gx, gy, gz;
+        gradientOf(hash, gx, gy, gz);
+        float dot = gx * dx + gy * dy + gz * dz;
+        float t2 = t * t;
+        float t4 = t2 * t2;
+        value += t4 * dot;
+        // d/dp (t^4 dot) = t^4 g - 8 t^3 dot d
+        float falloff = -8.0f * t2 * t * dot;
+        gradX += t4 * gx + falloff * dx;
+        gradY += t4 * gy + falloff * dy;
+        gradZ += t4 * gz + falloff * dz;
+    }
+
+    // ---- SIMD lanes, same arithmetic as the scalar versions above ----
+
+    void gradientLanes(simd::VInt hash, simd::VFloat& gx, simd::VFloat& gy, simd::VFloat& gz) {
+        using namespace simd;
+        const VInt h = hash & set1i(15);
+        const VInt zero = set1i(0);
+        const VFloat one = set1(1.0f);
+        VFloat u = one ^ asFloat(shiftLeft<31>(h & set1i(1)));
+        VFloat v = one ^ asFloat(shiftLeft<30>(h & set1i(2)));
+        VFloat uIsX = asFloat(equal(h & set1i(8), zero));
+        VFloat vIsY = asFloat(equal(h & set1i(12), zero));
+        VFloat vIsX = asFloat(equal(h & set1i(13), set1i(12)));
+        gx = (uIsX & u) + (vIsX & v);
+        gy = andNot(uIsX, u) + (vIsY & v);
+        gz = andNot(vIsY | vIsX, v);
+    }
+
+    simd::VFloat fadeLanes(simd::VFloat t) {
+        using namespace simd;
+        return t * t * t * (t * (t * set1(6.0f) - set1(15.0f)) + set1(10.0f));
+    }
+
+    simd::VFloat fadeDerivativeLanes(simd::VFloat t) {
+        using namespace simd;
+        VFloat tm1 = t - set1(1.0f);
+        return set1(30.0f) * t * t * tm1 * tm1;
+    }
+
+    simd::VFloat blendLanes(const simd::VFloat c[8], simd::VFloat u, simd::VFloat v, simd::VFloat w,
+                            simd::VFloat& du, simd::VFloat& dv, simd::VFloat& dw) {
+        using namespace simd;
+        VFloat k1 = c[1] - c[0];
+        VFloat k2 = c[2] - c[0];
+        VFloat k3 = c[4] - c[0];
+        VFloat k4 = c[0] - c[1] - c[2] + c[3];
+        VFloat k5 = c[0] - c[2] - c[4] + c[6];
+        VFloat k6 = c[0] - c[1] - c[4] + c[5];
+        VFloat k7 = c[1] + c[2] - c[3] + c[4] - c[5] - c[6] + c[7] - c[0];
+        // Partial derivatives with respect to the fade weights
+        du = k1 + k4 * v + k6 * w + k7 * v * w;
+        dv = k2 + k5 * w + k4 * u + k7 * w * u;
+        dw = k3 + k6 * u + k5 * v + k7 * u * v;
+        return c[0] + k1 * u + k2 * v + k3 * w + k4 * u * v + k5 * v * w + k6 * w * u + k7 * u * v * w;
+    }
+
+    void perlinLanes(const int32_t* p, simd::VFloat x, simd::VFloat y, simd::VFloat z,
+                     simd::VFloat& value, simd::VFloat& gradX, simd::VFloat& gradY, simd::VFloat& gradZ) {
+        using namespace simd;
+        const VInt mask = set1i(255);
+        const VInt one = set1i(1);
+        VFloat fx = floor(x), fy = floor(y), fz = floor(z);
+        VInt X = truncate(fx) & mask, Y = truncate(fy) & mask, Z = truncate(fz) & mask;
+        x = x - fx;
+        y = y - fy;
+        z = z - fz;
+
+        VInt A = gather(p, X) + Y;
+        VInt B = gather(p, X + one) + Y;
+        VInt AA = gather(p, A) + Z, AB = gather(p, A + one) + Z;
+        VInt BA = gather(p, B) + Z, BB = gather(p, B + one) + Z;
+        // Corner x + 2y + 4z
+        const VInt hashes[8] = {
+            gather(p, AA), gather(p, BA), gather(p, AB), gather(p, BB),
+            gather(p, AA + one), gather(p, BA + one), gather(p, AB + one), gather(p, BB + one)
+        };
+
+        const VFloat vOne = set1(1.0f);
+        VFloat dots[8], gxs[8], gys[8], gzs[8];
+        for (int c = 0; c < 8; ++c) {
+            VFloat dx = (c & 1) ? x - vOne : x;
+            VFloat dy = (c & 2) ? y - vOne : y;
+            VFloat dz = (c & 4) ? z - vOne : z;
+            gradientLanes(hashes[c], gxs[c], gys[c], gzs[c]);
+            dots[c] = gxs[c] * dx + gys[c] * dy + gzs[c] * dz;
+        }
+
+        VFloat u = fadeLanes(x), v = fadeLanes(y), w = fadeLanes(z);
+        VFloat du, dv, dw, unused0, unused1, unused2;
+        value = blendLanes(dots, u, v, w, du, dv, dw);
+        // Blended corner gradients plus the change of the blend weights
+        gradX = blendLanes(gxs, u, v, w, unused0, unused1, unused2) + fadeDerivativeLanes(x) * du;
+        gradY = blendLanes(gys, u, v, w, unused0, unused1, unused2) + fadeDerivativeLanes(y) * dv;
+        gradZ = blendLanes(gzs, u, v, w, unused0, unused1, unused2) + fadeDerivativeLanes(z) * dw;
+    }
+
+    void simplexCornerLanes(simd::VInt hash, simd::VFloat dx, simd::VFloat dy, simd::VFloat dz,
+                            simd::VFloat& value, simd::VFloat& gradX, simd::VFloat& gradY, simd::VFloat& gradZ) {
+        using namespace simd;
+        VFloat t = set1(SIMPLEX_RADIUS2) - dx * dx - dy * dy - dz * dz;
+        t = max(t, set1(0.0f));
+        VFloat gx, gy, gz;
+        gradientLanes(hash, gx, gy, gz);
+        VFloat dot = gx * dx + gy * dy + gz * dz;
+        VFloat t2 = t * t;
+        VFloat t4 = t2 * t2;
+        value = value + t4 * dot;
+        VFloat falloff = set1(-8.0f) * t2 * t * dot;
+        gradX = gradX + t4 * gx + falloff * dx;
+        gradY = gradY + t4 * gy + falloff * dy;
+        gradZ = gradZ + t4 * gz + falloff * dz;
+    }
+
+    void simplexLanes(const int32_t* p, simd::VFloat x, simd::VFloat y, simd::VFloat z,
+                      simd::VFloat& value, simd::VFloat& gradX, simd::VFloat& gradY, simd::VFloat& gradZ) {
+        using namespace simd;
+        const VFloat vOne = set1(1.0f);
+        const VFloat g3 = set1(G3);
+        VFloat s = (x + y + z) * set1(F3);
+        VFloat fi = floor(x + s), fj = floor(y + s), fk = floor(z + s);
+        VFloat t = (fi + fj + fk) * g3;
+        VFloat x0 = x - (fi - t), y0 = y - (fj - t), z0 = z - (fk - t);
+
+        // Which simplex of the skewed cube the point is in, with the scalar tie rules
+        VFloat xy = andNot(less(x0, y0), trueMask());
+        VFloat xz = andNot(less(x0, z0), trueMask());
+        VFloat yz = andNot(less(y0, z0), trueMask());
+        VFloat i1 = xy & xz, j1 = andNot(xy, yz), k1 = andNot(xz | yz, trueMask());
+        VFloat i2 = xy | xz, j2 = andNot(xy, trueMask()) | yz, k2 = andNot(xz & yz, trueMask());
+        i1 = i1 & vOne; j1 = j1 & vOne; k1 = k1 & vOne;
+        i2 = i2 & vOne; j2 = j2 & vOne; k2 = k2 & vOne;
+
+        const VInt mask = set1i(255);
+        const VInt one = set1i(1);
+        VInt ii = truncate(fi) & mask, jj = truncate(fj) & mask, kk = truncate(fk) & mask;
+        VInt h0 = gather(p, ii + gather(p, jj + gather(p, kk)));
+        VInt h1 = gather(p, ii + truncate(i1) + gather(p, jj + truncate(j1) + gather(p, kk + truncate(k1))));
+        VInt h2 = gather(p, ii + truncate(i2) + gather(p, jj + truncate(j2) + gather(p, kk + truncate(k2))));
+        VInt h3 = gather(p, ii + one + gather(p, jj + one + gather(p, kk + one)));
+
+        value = gradX = gradY = gradZ = set1(0.0f);
+        simplexCornerLanes(h0, x0, y0, z0, value, gradX, gradY, gradZ);
+        simplexCornerLanes(h1, x0 - i1 + g3, y0 - j1 + g3, z0 - k1 + g3, value, gradX, gradY, gradZ);
+        simplexCornerLanes(h2, x0 - i2 + set1(2.0f * G3), y0 - j2 + set1(2.0f * G3), z0 - k2 + set1(2.0f * G3),
+                           value, gradX, gradY, gradZ);
+        const VFloat last = set1(1.0f - 3.0f * G3);
+        simplexCornerLanes(h3, x0 - last, y0 - last, z0 - last, value, gradX, gradY, gradZ);
+
+        const VFloat scale = set1(SIMPLEX_SCALE);
+        value = value * scale;
+        gradX = gradX * scale;
+        gradY = gradY * scale;
+        gradZ = gradZ * scale;
+    }
+}
 
 PerlinNoise::PerlinNoise() {
-    generatePermutation();
+    generatePermutation(0);
 }
 
-void PerlinNoise::generatePermutation() {
+PerlinNoise::PerlinNoise(unsigned seed) {
+    generatePermutation(seed);
+}
+
+void PerlinNoise::generatePermutation(unsigned seed) {
     std::vector<int> temp(256);
     std::iota(temp.begin(), temp.end(), 0);
-    std::shuffle(temp.begin(), temp.end(), std::default_random_engine(0)); // Fixed seed
-    p.resize(512);
+    std::shuffle(temp.begin(), temp.end(), std::default_random_engine(seed));
     for (int i = 0; i < 256; ++i) {
         p[i] = p[i + 256] = temp[i];
     }
 }
 
-float PerlinNoise::fade(float t) {
+float PerlinNoise::fade(float t) const {
     return t * t * t * (t * (t * 6 - 15) + 10);
 }
 
-float PerlinNoise::grad(int hash, float x, float y, float z) {
+float PerlinNoise::grad(int hash, float x, float y, float z) const {
     int h = hash & 15;
     float u = h < 8 ? x : y;
     float v = h < 4 ? y : h == 12 || h == 14 ? x : z;
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
 }
 
-float PerlinNoise::lerp(float t, float a, float b) {
+float PerlinNoise::lerp(float t, float a, float b) const {
     return a + t * (b - a);
 }
 
-// In PerlinNoise.cpp
-
-float PerlinNoise::noise(float x, float y, float z) {
+float PerlinNoise::noise(float x, float y, float z) const {
     int X = (int)std::floor(x) & 255;
     int Y = (int)std::floor(y) & 255;
     int Z = (int)std::floor(z) & 255;
@@ -68,4 +292,128 @@ float PerlinNoise::noise(float x, float y, float z) {
                                 lerp(u, grad(p[AB + 1], x, y - 1, z - 1),
                                          grad(p[BB + 1], x - 1, y - 1, z - 1))));
     return (res + 1.0f) / 2.0f; // Return value in range [0, 1]
-}
\ No newline at end of file
+}
+
+NoiseSample PerlinNoise::sample(NoiseKind kind, float x, float y, float z) const {
+    if (kind == NoiseKind::Simplex) {
+        float s = (x + y + z) * F3;
+        float fi = std::floor(x + s), fj = std::floor(y + s), fk = std::floor(z + s);
+        float t = (fi + fj + fk) * G3;
+        float x0 = x - (fi - t), y0 = y - (fj - t), z0 = z - (fk - t);
+
+        bool xy = x0 >= y0, xz = x0 >= z0, yz = y0 >= z0;
+        int i1 = xy && xz, j1 = !xy && yz, k1 = !xz && !yz;
+        int i2 = xy || xz, j2 = !xy || yz, k2 = !(xz && yz);
+
+        int ii = static_cast<int>(fi) & 255, jj = static_cast<int>(fj) & 255, kk = static_cast<int>(fk) & 255;
+        float value = 0.0f, gx = 0.0f, gy = 0.0f, gz = 0.0f;
+        simplexCorner(p[ii + p[jj + p[kk]]], x0, y0, z0, value, gx, gy, gz);
+        simplexCorner(p[ii + i1 + p[jj + j1 + p[kk + k1]]],
+                      x0 - i1 + G3, y0 - j1 + G3, z0 - k1 + G3, value, gx, gy, gz);
+        simplexCorner(p[ii + i2 + p[jj + j2 + p[kk + k2]]],
+                      x0 - i2 + 2.0f * G3, y0 - j2 + 2.0f * G3, z0 - k2 + 2.0f * G3, value, gx, gy, gz);
+        const float last = 1.0f - 3.0f * G3;
+        simplexCorner(p[ii + 1 + p[jj + 1 + p[kk + 1]]], x0 - last, y0 - last, z0 - last, value, gx, gy, gz);
+        return toUnitRange(SIMPLEX_SCALE * value, SIMPLEX_SCALE * gx, SIMPLEX_SCALE * gy, SIMPLEX_SCALE * gz);
+    }
+
+    int X = (int)std::floor(x) & 255;
+    int Y = (int)std::floor(y) & 255;
+    int Z = (int)std::floor(z) & 255;
+    x -= std::floor(x);
+    y -= std::floor(y);
+    z -= std::floor(z);
+
+    int A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+    int B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+    const int hashes[8] = {p[AA], p[BA], p[AB], p[BB], p[AA + 1], p[BA + 1], p[AB + 1], p[BB + 1]};
+
+    float dots[8], gxs[8], gys[8], gzs[8];
+    for (int c = 0; c < 8; ++c) {
+        float dx = (c & 1) ? x - 1.0f : x;
+        float dy = (c & 2) ? y - 1.0f : y;
+        float dz = (c & 4) ? z - 1.0f : z;
+        gradientOf(hashes[c], gxs[c], gys[c], gzs[c]);
+        dots[c] = gxs[c] * dx + gys[c] * dy + gzs[c] * dz;
+    }
+
+    float u = fade(x), v = fade(y), w = fade(z);
+    TrilinearTerms k = trilinearTerms(dots);
+    float value = blend(k, u, v, w);
+    float gradX = blend(trilinearTerms(gxs), u, v, w) + fadeDerivative(x) * (k.k1 + k.k4 * v + k.k6 * w + k.k7 * v * w);
+    float gradY = blend(trilinearTerms(gys), u, v, w) + fadeDerivative(y) * (k.k2 + k.k5 * w + k.k4 * u + k.k7 * w * u);
+    float gradZ = blend(trilinearTerms(gzs), u, v, w) + fadeDerivative(z) * (k.k3 + k.k6 * u + k.k5 * v + k.k7 * u * v);
+    return toUnitRange(value, gradX, gradY, gradZ);
+}
+
+void PerlinNoise::evaluate(NoiseKind kind, const NoiseBatch& batch) const {
+    const bool gradients = batch.gradX && batch.gradY && batch.gradZ;
+    // Without vector units the emulated lanes are slower than sample() one point at a time
+#if defined(SPIDER_SIMD_SCALAR)
+    const bool vectorized = false;
+#else
+    const bool vectorized = true;
+#endif
+    if (!vectorized) {
+        for (size_t i = 0; i < batch.count; ++i) {
+            NoiseSample s = sample(kind, batch.x[i], batch.y[i], batch.z[i]);
+            batch.value[i] = s.value;
+            if (gradients) {
+                batch.gradX[i] = s.dx;
+                batch.gradY[i] = s.dy;
+                batch.gradZ[i] = s.dz;
+            }
+        }
+        return;
+    }
+
+    const simd::VFloat half = simd::set1(0.5f);
+    for (size_t first = 0; first < batch.count; first += simd::WIDTH) {
+        const size_t valid = std::min(static_cast<size_t>(simd::WIDTH), batch.count - first);
+        simd::VFloat x, y, z;
+        if (valid == static_cast<size_t>(simd::WIDTH)) {
+            x = simd::load(batch.x + first);
+            y = simd::load(batch.y + first);
+            z = simd::load(batch.z + first);
+        } else {
+            // The tail repeats its last point so every lane stays finite
+            float lx[simd::WIDTH], ly[simd::WIDTH], lz[simd::WIDTH];
+            for (int l = 0; l < simd::WIDTH; ++l) {
+                size_t i = first + std::min(static_cast<size_t>(l), valid - 1);
+                lx[l] = batch.x[i];
+                ly[l] = batch.y[i];
+                lz[l] = batch.z[i];
+            }
+            x = simd::load(lx);
+            y = simd::load(ly);
+            z = simd::load(lz);
+        }
+
+        simd::VFloat value, gx, gy, gz;
+        if (kind == NoiseKind::Simplex) {
+            simplexLanes(p, x, y, z, value, gx, gy, gz);
+        } else {
+            perlinLanes(p, x, y, z, value, gx, gy, gz);
+        }
+
+        float out[4][simd::WIDTH];
+        simd::store(out[0], value * half + half);
+        simd::store(out[1], gx * half);
+        simd::store(out[2], gy * half);
+        simd::store(out[3], gz * half);
+        std::copy(out[0], out[0] + valid, batch.value + first);
+        if (gradients) {
+            std::copy(out[1], out[1] + valid, batch.gradX + first);
+            std::copy(out[2], out[2] + valid, batch.gradY + first);
+            std::copy(out[3], out[3] + valid, batch.gradZ + first);
+        }
+    }
+}
+
+int PerlinNoise::batchWidth() {
+    return simd::WIDTH;
+}
+
+const char* PerlinNoise::batchInstructionSet() {
+    return simd::instructionSet();
+}
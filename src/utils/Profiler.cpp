@@ -0,0 +1,132 @@
+// Description: Source file for the scoped CPU trace profiler.
+#include "utils/Profiler.h"
+
+#if SPIDER_PROFILING
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace profiler {
+
+namespace {
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+    };
+
+    // Written only by its thread; the dump reads it while it runs
+    struct ThreadRing {
+        uint32_t threadId;
+        std::atomic<const char*> name;
+        std::vector<Event> events;
+        std::atomic<uint64_t> written;   // events ever recorded, the slot is written % RING_CAPACITY
+
+        explicit ThreadRing(uint32_t id) : threadId(id), name(nullptr), events(RING_CAPACITY), written(0) {}
+    };
+
+    // Rings outlive their threads, so a dump after a worker exits still has its events
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadRing>> rings;
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    ThreadRing& threadRing() {
+        thread_local ThreadRing* ring = nullptr;
+        if (ring == nullptr) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.rings.emplace_back(new ThreadRing(static_cast<uint32_t>(reg.rings.size() + 1)));
+            ring = reg.rings.back().get();
+        }
+        return *ring;
+    }
+
+    void writeEscaped(FILE* file, const char* text) {
+        for (const char* c = text; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                std::fputc('\\', file);
+            }
+            std::fputc(*c, file);
+        }
+    }
+}
+
+uint64_t nowNs() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadRing& ring = threadRing();
+    uint64_t index = ring.written.load(std::memory_order_relaxed);
+    Event& event = ring.events[index % RING_CAPACITY];
+    event.name = name;
+    event.startNs = startNs;
+    event.endNs = endNs;
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+void setThreadName(const char* name) {
+    threadRing().name.store(name, std::memory_order_release);
+}
+
+bool writeChromeTrace(const char* path) {
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<Event> copy;
+    bool first = true;
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    for (const std::unique_ptr<ThreadRing>& ring : reg.rings) {
+        if (const char* name = ring->name.load(std::memory_order_acquire)) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                         first ? "" : ",\n", ring->threadId);
+            writeEscaped(file, name);
+            std::fputs("\"}}", file);
+            first = false;
+        }
+
+        // Copy the newest events, then drop any the owner may have overwritten meanwhile
+        uint64_t end = ring->written.load(std::memory_order_acquire);
+        uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+        copy.clear();
+        for (uint64_t i = begin; i < end; ++i) {
+            copy.push_back(ring->events[i % RING_CAPACITY]);
+        }
+        // The slot of event number `after` may be mid-write, hence the + 1
+        uint64_t after = ring->written.load(std::memory_order_acquire);
+        uint64_t firstIntact = after + 1 > RING_CAPACITY ? after + 1 - RING_CAPACITY : 0;
+        uint64_t skip = firstIntact > begin ? firstIntact - begin : 0;
+
+        for (size_t i = static_cast<size_t>(skip); i < copy.size(); ++i) {
+            const Event& event = copy[i];
+            // Timestamps are in microseconds; keep the nanoseconds as decimals
+            std::fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+            writeEscaped(file, event.name);
+            std::fprintf(file, "\",\"cat\":\"spider\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         ring->threadId, event.startNs / 1000.0, (event.endNs - event.startNs) / 1000.0);
+            first = false;
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+} // namespace profiler
+
+#endif // SPIDER_PROFILING
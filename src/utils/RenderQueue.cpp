@@ -0,0 +1,96 @@
+// Description: Source file for the render queue.
+#include "utils/RenderQueue.h"
+#include "utils/DrawStats.h"
+#include <algorithm>
+#include <cstring>
+
+RenderQueue::RenderQueue()
+    : stats_{0, 0, 0, 0} {
+}
+
+void RenderQueue::begin(const mat4& view) {
+    view_ = view;
+    packets_.clear();
+    order_.clear();
+    stats_ = RenderQueueStats{0, 0, 0, 0};
+}
+
+void RenderQueue::push(const DrawPacket& packet) {
+    if (packet.count == 0) {
+        return;
+    }
+    // Depth of the object's origin; good enough to order whole parts front to back
+    vec4 origin = view_ * vec4(packet.model[0][3], packet.model[1][3], packet.model[2][3], 1.0f);
+    SortEntry entry = {makeKey(packet.program, packet.vertexArray, -origin.z), static_cast<uint32_t>(packets_.size())};
+    order_.push_back(entry);
+    packets_.push_back(packet);
+}
+
+uint64_t RenderQueue::makeKey(GLuint program, GLuint vertexArray, float depth) {
+    // Non-negative IEEE floats order like their bit patterns
+    uint32_t depthBits = 0;
+    if (depth > 0.0f) {
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+    }
+    return (static_cast<uint64_t>(program & 0xFFFu) << 52) |
+           (static_cast<uint64_t>(vertexArray & 0xFFFFFu) << 32) |
+           depthBits;
+}
+
+void RenderQueue::flush() {
+    std::sort(order_.begin(), order_.end(), [](const SortEntry& a, const SortEntry& b) {
+        return a.key < b.key;
+    });
+
+    stats_.packets += order_.size();
+    GLuint program = 0;
+    GLuint vertexArray = 0;
+    GLuint texture = 0;
+    bool first = true;
+
+    for (const SortEntry& entry : order_) {
+        const DrawPacket& packet = packets_[entry.packet];
+        if (first || packet.program != program) {
+            program = packet.program;
+            glUseProgram(program);
+            ++stats_.programChanges;
+        }
+        if (first || packet.vertexArray != vertexArray) {
+            vertexArray = packet.vertexArray;
+            glBindVertexArray(vertexArray);
+            ++stats_.vertexArrayChanges;
+        }
+        if (packet.texture != 0 && packet.texture != texture) {
+            texture = packet.texture;
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            ++stats_.textureChanges;
+        }
+        first = false;
+
+        if (packet.modelLoc >= 0) {
+            glUniformMatrix4fv(packet.modelLoc, 1, GL_TRUE, packet.model);
+        }
+        if (packet.colorLoc >= 0) {
+            glUniform4fv(packet.colorLoc, 1, packet.color);
+        }
+
+        if (packet.indexed) {
+            glDrawElements(GL_TRIANGLES, packet.count, GL_UNSIGNED_INT, nullptr);
+        } else {
+            glDrawArrays(GL_TRIANGLES, 0, packet.count);
+        }
+        recordDrawCall(1, packet.count / 3);
+    }
+
+    // Leave no VAO bound for code that still draws outside the queue
+    if (!first) {
+        glBindVertexArray(0);
+    }
+    packets_.clear();
+    order_.clear();
+}
+
+const RenderQueueStats& RenderQueue::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,34 @@
+// Description: Source file for view-frustum planes and sphere visibility tests.
+#include "utils/ViewFrustum.h"
+#include <cmath>
+
+ViewFrustum::ViewFrustum(const mat4& viewProjection) {
+    // Angel matrices are row-major, so m[i] is row i
+    const vec4& r0 = viewProjection[0];
+    const vec4& r1 = viewProjection[1];
+    const vec4& r2 = viewProjection[2];
+    const vec4& r3 = viewProjection[3];
+
+    planes_[0] = r3 + r0;   // left
+    planes_[1] = r3 - r0;   // right
+    planes_[2] = r3 + r1;   // bottom
+    planes_[3] = r3 - r1;   // top
+    planes_[4] = r3 + r2;   // near
+    planes_[5] = r3 - r2;   // far
+
+    for (vec4& plane : planes_) {
+        float len = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (len > 0.0f) {
+            plane /= len;
+        }
+    }
+}
+
+bool ViewFrustum::intersectsSphere(const vec3& center, float radius) const {
+    for (const vec4& plane : planes_) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}